@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    AtticAudioRing.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticAudioRing.h"
+
+//==============================================================================
+bool AtticAudioRing::create (const juce::File& file, int numChannelsToUse, int capacityInFrames)
+{
+    jassert (numChannelsToUse > 0 && capacityInFrames > 0);
+    close();
+
+    const auto newCapacity = (juce::uint32) juce::nextPowerOfTwo (capacityInFrames);
+    const auto totalSize = dataOffset + (size_t) newCapacity * (size_t) numChannelsToUse * sizeof (float);
+
+    // Sizes the file up front, the mapping can't grow it..
+    juce::MemoryBlock zeros (totalSize, true);
+
+    if (! file.getParentDirectory().createDirectory() || ! file.replaceWithData (zeros.getData(), zeros.getSize()))
+        return false;
+
+    if (! map (file))
+        return false;
+
+    header = new (mappedFile->getData()) Header {};
+    header->numChannels = (juce::uint32) numChannelsToUse;
+    header->capacity = newCapacity;
+
+    numChannels = numChannelsToUse;
+    capacity = newCapacity;
+    mask = (juce::uint64) capacity - 1;
+
+    // The magic number goes in last, so a reader never sees a half-initialised header..
+    std::atomic_thread_fence (std::memory_order_release);
+    header->magic = ringMagic;
+
+    return true;
+}
+
+bool AtticAudioRing::open (const juce::File& file, int expectedNumChannels)
+{
+    jassert (expectedNumChannels > 0);
+    close();
+
+    if (! map (file))
+        return false;
+
+    // Read once, so that nothing written to the header later can change what was checked..
+    const auto magic = header->magic;
+    std::atomic_thread_fence (std::memory_order_acquire);
+    const auto mappedChannels = header->numChannels;
+    const auto mappedCapacity = header->capacity;
+
+    const auto expectedSize = (juce::uint64) dataOffset
+                            + (juce::uint64) mappedCapacity * mappedChannels * sizeof (float);
+
+    if (magic != ringMagic
+         || mappedCapacity == 0 || ! juce::isPowerOfTwo (mappedCapacity)
+         || mappedChannels != (juce::uint32) expectedNumChannels
+         || (juce::uint64) mappedFile->getSize() < expectedSize)
+    {
+        close();
+        return false;
+    }
+
+    numChannels = expectedNumChannels;
+    capacity = mappedCapacity;
+    mask = (juce::uint64) capacity - 1;
+    return true;
+}
+
+void AtticAudioRing::close()
+{
+    header = nullptr;
+    frames = nullptr;
+    numChannels = 0;
+    capacity = 0;
+    mask = 0;
+    mappedFile.reset();
+    backingFile = juce::File();
+}
+
+bool AtticAudioRing::map (const juce::File& file)
+{
+    mappedFile = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readWrite);
+
+    if (mappedFile->getData() == nullptr || mappedFile->getSize() < dataOffset)
+    {
+        mappedFile.reset();
+        return false;
+    }
+
+    backingFile = file;
+    header = static_cast<Header*> (mappedFile->getData());
+    frames = reinterpret_cast<float*> (static_cast<char*> (mappedFile->getData()) + dataOffset);
+    return true;
+}
+
+//==============================================================================
+juce::uint64 AtticAudioRing::getDistance (juce::uint64 from, juce::uint64 to) const noexcept
+{
+    // A position that has run backwards, or further ahead than the ring holds, can only come from
+    // a broken peer. It's clamped so it can't turn into a bad count, and the indices stay masked..
+    return juce::jmin (to - from, (juce::uint64) capacity);
+}
+
+int AtticAudioRing::getFreeSpace() const noexcept
+{
+    if (! isOpen())
+        return 0;
+
+    const auto writePosition = header->writePosition.load (std::memory_order_relaxed);
+    const auto readPosition = header->readPosition.load (std::memory_order_acquire);
+    return (int) (capacity - getDistance (readPosition, writePosition));
+}
+
+int AtticAudioRing::getNumReady() const noexcept
+{
+    if (! isOpen())
+        return 0;
+
+    const auto writePosition = header->writePosition.load (std::memory_order_acquire);
+    const auto readPosition = header->readPosition.load (std::memory_order_relaxed);
+    return (int) getDistance (readPosition, writePosition);
+}
+
+void AtticAudioRing::requestWakeUp() noexcept
+{
+    if (! isOpen())
+        return;
+
+    header->wakeUpRequested.store (1);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+}
+
+bool AtticAudioRing::takeWakeUpRequest() noexcept
+{
+    if (! isOpen())
+        return false;
+
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    return header->wakeUpRequested.load (std::memory_order_relaxed) != 0
+        && header->wakeUpRequested.exchange (0) != 0;
+}
+
+int AtticAudioRing::write (const float* const* channels, int numFrames) noexcept
+{
+    const auto numToWrite = juce::jmin (numFrames, getFreeSpace());
+
+    if (numToWrite <= 0)
+        return 0;
+
+    const auto writePosition = header->writePosition.load (std::memory_order_relaxed);
+
+    for (int i = 0; i < numToWrite; ++i)
+    {
+        auto* frame = frames + ((writePosition + (juce::uint64) i) & mask) * (juce::uint64) numChannels;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            frame[channel] = channels[channel][i];
+    }
+
+    header->writePosition.store (writePosition + (juce::uint64) numToWrite, std::memory_order_release);
+    return numToWrite;
+}
+
+int AtticAudioRing::read (float* const* channels, int numFrames) noexcept
+{
+    const auto numToRead = juce::jmin (numFrames, getNumReady());
+
+    if (numToRead <= 0)
+        return 0;
+
+    const auto readPosition = header->readPosition.load (std::memory_order_relaxed);
+
+    for (int i = 0; i < numToRead; ++i)
+    {
+        const auto* frame = frames + ((readPosition + (juce::uint64) i) & mask) * (juce::uint64) numChannels;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            channels[channel][i] = frame[channel];
+    }
+
+    header->readPosition.store (readPosition + (juce::uint64) numToRead, std::memory_order_release);
+    return numToRead;
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    AtticAudioRing.h
+
+    A single-producer, single-consumer ring of audio frames living in a
+    memory-mapped file, so that a client process and the service can pass
+    audio to each other without locks or system calls. The read and write
+    positions are lock-free atomics in the file's header; the frames follow
+    it, interleaved. The other process can write anything to the mapping, so
+    the shape of the ring is read and checked once, when it's created or
+    opened, and only the positions are read from it after that..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+*/
+class AtticAudioRing
+{
+public:
+    //==============================================================================
+    AtticAudioRing() = default;
+    ~AtticAudioRing() = default;
+
+    // Creates (or overwrites) the backing file. The capacity is rounded up to a power of two..
+    bool create (const juce::File& file, int numChannelsToUse, int capacityInFrames);
+
+    // Maps a ring that another process has created, failing unless it has expectedNumChannels channels..
+    bool open (const juce::File& file, int expectedNumChannels);
+
+    void close();
+
+    bool isOpen() const noexcept                { return header != nullptr; }
+    int getNumChannels() const noexcept         { return numChannels; }
+    int getCapacity() const noexcept            { return (int) capacity; }
+    const juce::File& getFile() const noexcept  { return backingFile; }
+
+    //==============================================================================
+    // Producer side. Returns the number of frames actually written..
+    int write (const float* const* channels, int numFrames) noexcept;
+    int getFreeSpace() const noexcept;
+
+    // Consumer side. Returns the number of frames actually read..
+    int read (float* const* channels, int numFrames) noexcept;
+    int getNumReady() const noexcept;
+
+    // Lets a side that's about to sleep ask the other one for a wake-up when it next moves the
+    // ring on; takeWakeUpRequest() returns true once per request. Both are full fences, so a
+    // request can't pass a position update in the other direction unnoticed..
+    void requestWakeUp() noexcept;
+    bool takeWakeUpRequest() noexcept;
+
+private:
+    //==============================================================================
+    struct Header
+    {
+        juce::uint32 magic;
+        juce::uint32 numChannels;
+        juce::uint32 capacity;
+        alignas (64) std::atomic<juce::uint64> writePosition;
+        alignas (64) std::atomic<juce::uint64> readPosition;
+        alignas (64) std::atomic<juce::uint32> wakeUpRequested;
+    };
+
+    // The positions are shared between processes, which is only sound for atomics that never take a lock..
+    static_assert (std::atomic<juce::uint64>::is_always_lock_free, "Ring positions must be lock-free");
+    static_assert (std::atomic<juce::uint32>::is_always_lock_free, "Ring flags must be lock-free");
+
+    static constexpr juce::uint32 ringMagic = 0x41524e47; // 'ARNG'
+    static constexpr size_t dataOffset = (sizeof (Header) + 63) & ~(size_t) 63;
+
+    bool map (const juce::File& file);
+
+    // How many frames lie between two positions, which the other side may have made up..
+    juce::uint64 getDistance (juce::uint64 from, juce::uint64 to) const noexcept;
+
+    juce::File backingFile;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    Header* header = nullptr;
+    float* frames = nullptr;
+
+    // Private copies of the header's shape, checked against the mapping's size..
+    int numChannels = 0;
+    juce::uint32 capacity = 0;
+    juce::uint64 mask = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticAudioRing)
+};
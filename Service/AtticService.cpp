@@ -0,0 +1,500 @@
+/*
+  ==============================================================================
+
+    AtticService.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticService.h"
+
+//==============================================================================
+// One hosted processor and the two rings it's fed through..
+class AtticService::Stream
+{
+public:
+    Stream (int streamId, int numChannels, double sampleRate, int samplesPerBlock)
+        : id (streamId), blockSize (samplesPerBlock), buffer (numChannels, samplesPerBlock)
+    {
+        processor.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+        processor.setNonRealtime (false);
+        processor.prepareToPlay (sampleRate, blockSize);
+    }
+
+    ~Stream()
+    {
+        processor.releaseResources();
+
+        input.close();
+        output.close();
+
+        for (auto& file : { inputFile, outputFile })
+            file.deleteFile();
+    }
+
+    bool openRings (const juce::File& inputRingFile, const juce::File& outputRingFile, int capacity)
+    {
+        inputFile = inputRingFile;
+        outputFile = outputRingFile;
+
+        return input.create (inputFile, buffer.getNumChannels(), capacity)
+            && output.create (outputFile, buffer.getNumChannels(), capacity);
+    }
+
+    bool canProcess() const noexcept
+    {
+        return input.getNumReady() >= blockSize && output.getFreeSpace() >= blockSize;
+    }
+
+    // Called by the stream's worker. Processes one block when a whole one is waiting and there's room for the result..
+    bool processPending()
+    {
+        if (! canProcess())
+            return false;
+
+        input.read (buffer.getArrayOfWritePointers(), blockSize);
+
+        {
+            const juce::ScopedLock sl (processor.getCallbackLock());
+            processor.processBlock (buffer, midi);
+        }
+
+        output.write (buffer.getArrayOfReadPointers(), blockSize);
+        midi.clear();
+        return true;
+    }
+
+    // Asks the client to send a "wake" for this stream the next time it pushes or pulls audio..
+    void requestWakeUps() noexcept
+    {
+        input.requestWakeUp();
+        output.requestWakeUp();
+    }
+
+    const int id;
+    const int blockSize;
+    AtticAudioProcessor processor;
+    Worker* worker = nullptr;
+    juce::int64 releasePass = 0;    // Last pass of its worker that can still see it, once it's been removed..
+    juce::File inputFile, outputFile;
+
+private:
+    AtticAudioRing input, output;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Stream)
+};
+
+//==============================================================================
+// Services its share of the streams in turn, and sleeps when none of them had a block waiting, until
+// a client moves one of their rings on. The lock only guards the list, each pass works on a copy of
+// it, so the message thread never waits for audio to be processed..
+class AtticService::Worker  : public juce::Thread
+{
+public:
+    Worker (int index, int coreToUse)
+        : juce::Thread ("Attic worker " + juce::String (index)), core (coreToUse)
+    {
+        jassert (core < 32); // setCurrentThreadAffinityMask takes a 32-bit mask, see checkOptions()..
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp();
+        stopThread (2000);
+    }
+
+    void addStream (Stream* stream)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            streams.add (stream);
+            stream->worker = this;
+        }
+
+        // So that the new stream's rings get their wake-up requests..
+        wakeUp();
+    }
+
+    void wakeUp() noexcept
+    {
+        work.signal();
+    }
+
+    // The pass in progress may still be processing the stream, so it mustn't be deleted until
+    // hasFinishedPass (stream->releasePass)..
+    void removeStream (Stream* stream)
+    {
+        const juce::ScopedLock sl (lock);
+        streams.removeFirstMatchingValue (stream);
+        stream->releasePass = passesStarted;
+    }
+
+    bool hasFinishedPass (juce::int64 pass) const noexcept
+    {
+        return passesFinished.load() >= pass;
+    }
+
+    int getNumStreams() const
+    {
+        const juce::ScopedLock sl (lock);
+        return streams.size();
+    }
+
+    void run() override
+    {
+        if (core >= 0)
+            juce::Thread::setCurrentThreadAffinityMask ((juce::uint32) 1 << core);
+
+        juce::Array<Stream*> pass;
+
+        while (! threadShouldExit())
+        {
+            juce::int64 passNumber;
+
+            {
+                const juce::ScopedLock sl (lock);
+                pass.clearQuick();
+                pass.addArray (streams);
+                passNumber = ++passesStarted;
+            }
+
+            auto didWork = false;
+
+            for (auto* stream : pass)
+                didWork = stream->processPending() || didWork;
+
+            // Before sleeping, every client is asked for a wake-up, then the rings are looked at once
+            // more, in case one of them moved on before its request was in place..
+            auto shouldSleep = ! didWork;
+
+            if (shouldSleep)
+            {
+                for (auto* stream : pass)
+                    stream->requestWakeUps();
+
+                for (auto* stream : pass)
+                    shouldSleep = shouldSleep && ! stream->canProcess();
+            }
+
+            passesFinished = passNumber;
+
+            if (shouldSleep)
+                work.wait (idleTimeoutMs);
+        }
+    }
+
+private:
+    // Only a fallback, in case a wake-up never arrives, e.g. from a client that died mid-push..
+    static constexpr int idleTimeoutMs = 100;
+
+    const int core;
+    juce::WaitableEvent work;
+    juce::CriticalSection lock;
+    juce::Array<Stream*> streams;
+    juce::int64 passesStarted = 0;              // Guarded by the lock..
+    std::atomic<juce::int64> passesFinished { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Worker)
+};
+
+//==============================================================================
+// One control client. Callbacks arrive on the message thread, which is where streams are managed..
+class AtticService::Connection  : public juce::InterprocessConnection
+{
+public:
+    explicit Connection (AtticService& s)
+        : juce::InterprocessConnection (true, (juce::uint32) AtticService::connectionMagic), service (s)
+    {
+    }
+
+    ~Connection() override
+    {
+        disconnect();
+    }
+
+    void connectionMade() override {}
+
+    void connectionLost() override
+    {
+        // Can't delete ourselves from inside our own callback. By the time this runs, the service
+        // may have been stopped or destroyed, taking this connection with it..
+        juce::MessageManager::callAsync ([owner = juce::WeakReference<AtticService> (&service),
+                                          connection = juce::WeakReference<Connection> (this)]
+        {
+            if (owner != nullptr && connection != nullptr)
+                owner->connections.removeObject (connection.get());
+        });
+    }
+
+    void messageReceived (const juce::MemoryBlock& message) override
+    {
+        const auto command = juce::ValueTree::readFromData (message.getData(), message.getSize());
+
+        // Sent from the client's audio thread, which doesn't wait for a reply..
+        if (command.hasType ("wake"))
+        {
+            service.wakeStream (command["stream"]);
+            return;
+        }
+
+        const auto reply = service.handleCommand (command);
+
+        juce::MemoryOutputStream out;
+        reply.writeToStream (out);
+        sendMessage (out.getMemoryBlock());
+    }
+
+private:
+    AtticService& service;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Connection)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Connection)
+};
+
+//==============================================================================
+AtticService::AtticService (const Options& o)
+    : options (o)
+{
+    if (options.ringDirectory == juce::File())
+    {
+       #if JUCE_LINUX
+        // tmpfs, so the rings never touch a disk..
+        if (juce::File ("/dev/shm").isDirectory())
+            options.ringDirectory = juce::File ("/dev/shm").getChildFile ("AtticService");
+        else
+       #endif
+            options.ringDirectory = juce::File::getSpecialLocation (juce::File::tempDirectory).getChildFile ("AtticService");
+    }
+}
+
+AtticService::~AtticService()
+{
+    stop();
+}
+
+juce::Result AtticService::checkOptions (const Options& o)
+{
+    // Workers are pinned with a 32-bit affinity mask, and a core the machine doesn't have
+    // would leave the mask pointing somewhere else entirely..
+    const auto numCores = juce::jmin (32, juce::SystemStats::getNumCpus());
+
+    for (auto core : o.cores)
+        if (! juce::isPositiveAndBelow (core, numCores))
+            return juce::Result::fail ("Core " + juce::String (core) + " is out of range, --cores must be between 0 and "
+                                         + juce::String (numCores - 1) + " on this machine");
+
+    return juce::Result::ok();
+}
+
+juce::Result AtticService::start()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const auto result = checkOptions (options);
+
+    if (result.failed())
+        return result;
+
+    for (int i = 0; i < juce::jmax (1, options.numWorkers); ++i)
+    {
+        const auto core = options.cores.isEmpty() ? -1 : options.cores[i % options.cores.size()];
+        workers.add (new Worker (i, core))->startThread();
+    }
+
+    if (! beginWaitingForSocket (options.port, "127.0.0.1"))
+        return juce::Result::fail ("Couldn't listen on port " + juce::String (options.port));
+
+    return juce::Result::ok();
+}
+
+void AtticService::stop()
+{
+    InterprocessConnectionServer::stop();
+    connections.clear();
+    stopTimer();
+
+    // Once the workers have stopped nothing else can be using the streams..
+    workers.clear();
+    streams.clear();
+    retiredStreams.clear();
+}
+
+void AtticService::timerCallback()
+{
+    deleteReleasedStreams();
+}
+
+juce::InterprocessConnection* AtticService::createConnectionObject()
+{
+    return connections.add (new Connection (*this));
+}
+
+//==============================================================================
+juce::ValueTree AtticService::handleCommand (const juce::ValueTree& command)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    juce::ValueTree reply ("reply");
+
+    auto fail = [&reply] (const juce::String& error)
+    {
+        reply.setProperty ("ok", false, nullptr);
+        reply.setProperty ("error", error, nullptr);
+        return reply;
+    };
+
+    if (command.hasType ("create"))
+        return createStream (command);
+
+    if (command.hasType ("shutdown"))
+    {
+        juce::MessageManager::callAsync ([] { juce::MessageManager::getInstance()->stopDispatchLoop(); });
+        reply.setProperty ("ok", true, nullptr);
+        return reply;
+    }
+
+    auto* stream = findStream (command["stream"]);
+
+    if (stream == nullptr)
+        return fail ("Unknown stream");
+
+    if (command.hasType ("destroy"))
+    {
+        destroyStream (stream->id);
+    }
+    else if (command.hasType ("setParameter"))
+    {
+        const auto parameterId = command["parameter"].toString();
+        juce::RangedAudioParameter* parameter = nullptr;
+
+        for (auto* p : stream->processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (p))
+                if (ranged->getParameterID() == parameterId)
+                    parameter = ranged;
+
+        if (parameter == nullptr)
+            return fail ("Unknown parameter " + parameterId);
+
+        const juce::ScopedLock sl (stream->processor.getCallbackLock());
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 ((float) command["value"]));
+    }
+    else if (command.hasType ("getState"))
+    {
+        juce::MemoryBlock state;
+
+        {
+            const juce::ScopedLock sl (stream->processor.getCallbackLock());
+            stream->processor.getStateInformation (state);
+        }
+
+        reply.setProperty ("state", state, nullptr);
+    }
+    else if (command.hasType ("setState"))
+    {
+        auto* state = command["state"].getBinaryData();
+
+        if (state == nullptr)
+            return fail ("Missing state");
+
+        const juce::ScopedLock sl (stream->processor.getCallbackLock());
+        stream->processor.setStateInformation (state->getData(), (int) state->getSize());
+    }
+    else
+    {
+        return fail ("Unknown command " + command.getType().toString());
+    }
+
+    reply.setProperty ("ok", true, nullptr);
+    return reply;
+}
+
+juce::ValueTree AtticService::createStream (const juce::ValueTree& command)
+{
+    const int numChannels = command["channels"];
+    const double sampleRate = command["sampleRate"];
+    const int blockSize = command["blockSize"];
+    const int capacity = command.getProperty ("capacity", blockSize * 8);
+
+    juce::ValueTree reply ("reply");
+    reply.setProperty ("ok", false, nullptr);
+
+    // The processor only supports mono and stereo layouts..
+    if (numChannels < 1 || numChannels > 2 || sampleRate <= 0.0 || blockSize <= 0 || capacity < blockSize * 2)
+    {
+        reply.setProperty ("error", "Invalid stream configuration", nullptr);
+        return reply;
+    }
+
+    const auto id = nextStreamId++;
+    auto stream = std::make_unique<Stream> (id, numChannels, sampleRate, blockSize);
+
+    const auto prefix = "attic-" + juce::String (juce::Process::getProcessId()) + "-" + juce::String (id);
+
+    if (! stream->openRings (options.ringDirectory.getChildFile (prefix + "-in.ring"),
+                             options.ringDirectory.getChildFile (prefix + "-out.ring"), capacity))
+    {
+        reply.setProperty ("error", "Couldn't create the stream's rings", nullptr);
+        return reply;
+    }
+
+    // New streams go to the least busy worker..
+    auto* worker = workers.getFirst();
+
+    for (auto* w : workers)
+        if (w->getNumStreams() < worker->getNumStreams())
+            worker = w;
+
+    worker->addStream (streams.add (stream.release()));
+
+    reply.setProperty ("ok", true, nullptr);
+    reply.setProperty ("stream", id, nullptr);
+    reply.setProperty ("input", streams.getLast()->inputFile.getFullPathName(), nullptr);
+    reply.setProperty ("output", streams.getLast()->outputFile.getFullPathName(), nullptr);
+    return reply;
+}
+
+void AtticService::destroyStream (int streamId)
+{
+    if (auto* stream = findStream (streamId))
+    {
+        // Taken off its worker first. Its worker may be in the middle of a pass over it, so rather
+        // than wait for that here, it's only deleted once the pass has finished..
+        stream->worker->removeStream (stream);
+        retiredStreams.add (streams.removeAndReturn (streams.indexOf (stream)));
+        deleteReleasedStreams();
+    }
+}
+
+void AtticService::deleteReleasedStreams()
+{
+    for (int i = retiredStreams.size(); --i >= 0;)
+    {
+        auto* stream = retiredStreams.getUnchecked (i);
+
+        if (stream->worker->hasFinishedPass (stream->releasePass))
+            retiredStreams.remove (i);
+    }
+
+    if (retiredStreams.isEmpty())
+        stopTimer();
+    else if (! isTimerRunning())
+        startTimer (5);
+}
+
+void AtticService::wakeStream (int streamId)
+{
+    if (auto* stream = findStream (streamId))
+        stream->worker->wakeUp();
+}
+
+AtticService::Stream* AtticService::findStream (int streamId) const
+{
+    for (auto* stream : streams)
+        if (stream->id == streamId)
+            return stream;
+
+    return nullptr;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    AtticService.h
+
+    A headless host for many AtticAudioProcessor instances. Each stream has
+    a processor and a pair of shared-memory rings (audio in from the client,
+    audio out to it). Streams are spread across a fixed pool of worker
+    threads, optionally pinned to cores, and are created and controlled over
+    a local socket..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "AtticAudioRing.h"
+
+//==============================================================================
+/**
+    Control messages are ValueTrees written with ValueTree::writeToStream. The
+    tree's type is the command and every reply is a "reply" tree with an "ok"
+    property, plus an "error" string when it failed:
+
+    create       channels, sampleRate, blockSize [, capacity]  -> stream, input, output
+    destroy      stream
+    setParameter stream, parameter, value (in the parameter's own range)
+    getState     stream                                        -> state
+    setState     stream, state
+    shutdown
+
+    A worker with nothing to do asks for a wake-up through each of its streams'
+    rings before it sleeps. A client that finds the request after pushing or
+    pulling audio sends "wake" with the stream's id, which gets no reply..
+*/
+class AtticService  : private juce::InterprocessConnectionServer,
+                      private juce::Timer
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        int port = 51730;
+        int numWorkers = 2;
+        juce::Array<int> cores;     // Core for each worker in turn, none means unpinned..
+        juce::File ringDirectory;   // Where the rings' backing files go, picked per platform if left empty..
+    };
+
+    static constexpr int connectionMagic = 0x41747463; // 'Attc'
+
+    explicit AtticService (const Options&);
+    ~AtticService() override;
+
+    // Returns why the options can't be used, e.g. a core this machine doesn't have..
+    static juce::Result checkOptions (const Options&);
+
+    // Starts the workers and begins listening. Must be called on the message thread..
+    juce::Result start();
+    void stop();
+
+private:
+    //==============================================================================
+    class Stream;
+    class Worker;
+    class Connection;
+
+    juce::InterprocessConnection* createConnectionObject() override;
+    void timerCallback() override;
+
+    juce::ValueTree handleCommand (const juce::ValueTree& command);
+    juce::ValueTree createStream (const juce::ValueTree& command);
+    void destroyStream (int streamId);
+    void deleteReleasedStreams();
+    void wakeStream (int streamId);
+    Stream* findStream (int streamId) const;
+
+    Options options;
+    juce::OwnedArray<Worker> workers;
+    juce::OwnedArray<Stream> streams;       // Only touched on the message thread..
+    juce::OwnedArray<Stream> retiredStreams; // Destroyed, but possibly still in a pass of their worker..
+    juce::OwnedArray<Connection, juce::CriticalSection> connections; // Added from the socket thread..
+    int nextStreamId = 1;
+
+    //==============================================================================
+    JUCE_DECLARE_WEAK_REFERENCEABLE (AtticService)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticService)
+};
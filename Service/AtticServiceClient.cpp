@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    AtticServiceClient.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticServiceClient.h"
+#include "AtticService.h"
+
+//==============================================================================
+AtticServiceClient::AtticServiceClient()
+    : juce::InterprocessConnection (false, (juce::uint32) AtticService::connectionMagic)
+{
+}
+
+AtticServiceClient::~AtticServiceClient()
+{
+    disconnect();
+}
+
+bool AtticServiceClient::connect (int port, int timeoutMs)
+{
+    return connectToSocket ("127.0.0.1", port, timeoutMs);
+}
+
+void AtticServiceClient::disconnect()
+{
+    InterprocessConnection::disconnect();
+    streams.clear();
+}
+
+void AtticServiceClient::connectionLost()
+{
+    replyReceived.signal();
+}
+
+void AtticServiceClient::messageReceived (const juce::MemoryBlock& message)
+{
+    {
+        const juce::ScopedLock sl (replyLock);
+        lastReply = juce::ValueTree::readFromData (message.getData(), message.getSize());
+    }
+
+    replyReceived.signal();
+}
+
+juce::ValueTree AtticServiceClient::sendCommand (const juce::ValueTree& command)
+{
+    {
+        const juce::ScopedLock sl (replyLock);
+        lastReply = {};
+    }
+
+    replyReceived.reset();
+
+    juce::MemoryOutputStream out;
+    command.writeToStream (out);
+
+    if (! sendMessage (out.getMemoryBlock()) || ! replyReceived.wait (replyTimeoutMs))
+    {
+        lastError = "No reply from the service";
+        return {};
+    }
+
+    const juce::ScopedLock sl (replyLock);
+
+    if (! lastReply.isValid())
+        lastError = "Connection lost";
+    else if (! (bool) lastReply["ok"])
+        lastError = lastReply["error"].toString();
+
+    return lastReply;
+}
+
+AtticServiceClient::StreamRings* AtticServiceClient::findStream (int streamId) const
+{
+    for (auto* stream : streams)
+        if (stream->id == streamId)
+            return stream;
+
+    return nullptr;
+}
+
+//==============================================================================
+int AtticServiceClient::createStream (int numChannels, double sampleRate, int blockSize, int capacity)
+{
+    juce::ValueTree command ("create");
+    command.setProperty ("channels", numChannels, nullptr);
+    command.setProperty ("sampleRate", sampleRate, nullptr);
+    command.setProperty ("blockSize", blockSize, nullptr);
+
+    if (capacity > 0)
+        command.setProperty ("capacity", capacity, nullptr);
+
+    const auto reply = sendCommand (command);
+
+    if (! (bool) reply["ok"])
+        return -1;
+
+    auto stream = std::make_unique<StreamRings>();
+    stream->id = reply["stream"];
+
+    if (! stream->input.open (juce::File (reply["input"].toString()), numChannels)
+     || ! stream->output.open (juce::File (reply["output"].toString()), numChannels))
+    {
+        lastError = "Couldn't open the stream's rings";
+        destroyStream (stream->id);
+        return -1;
+    }
+
+    return streams.add (stream.release())->id;
+}
+
+bool AtticServiceClient::destroyStream (int streamId)
+{
+    streams.removeObject (findStream (streamId));
+
+    juce::ValueTree command ("destroy");
+    command.setProperty ("stream", streamId, nullptr);
+    return sendCommand (command)["ok"];
+}
+
+bool AtticServiceClient::setParameter (int streamId, const juce::String& parameterId, float value)
+{
+    juce::ValueTree command ("setParameter");
+    command.setProperty ("stream", streamId, nullptr);
+    command.setProperty ("parameter", parameterId, nullptr);
+    command.setProperty ("value", value, nullptr);
+    return sendCommand (command)["ok"];
+}
+
+bool AtticServiceClient::getState (int streamId, juce::MemoryBlock& state)
+{
+    juce::ValueTree command ("getState");
+    command.setProperty ("stream", streamId, nullptr);
+
+    const auto reply = sendCommand (command);
+
+    if (auto* data = reply["state"].getBinaryData())
+    {
+        state = *data;
+        return true;
+    }
+
+    return false;
+}
+
+bool AtticServiceClient::setState (int streamId, const juce::MemoryBlock& state)
+{
+    juce::ValueTree command ("setState");
+    command.setProperty ("stream", streamId, nullptr);
+    command.setProperty ("state", state, nullptr);
+    return sendCommand (command)["ok"];
+}
+
+bool AtticServiceClient::shutdownService()
+{
+    return sendCommand (juce::ValueTree ("shutdown"))["ok"];
+}
+
+//==============================================================================
+int AtticServiceClient::push (int streamId, const float* const* channels, int numFrames)
+{
+    if (auto* stream = findStream (streamId))
+    {
+        const auto numWritten = stream->input.write (channels, numFrames);
+
+        if (stream->input.takeWakeUpRequest())
+            sendWakeUp (streamId);
+
+        return numWritten;
+    }
+
+    return 0;
+}
+
+int AtticServiceClient::pull (int streamId, float* const* channels, int numFrames)
+{
+    if (auto* stream = findStream (streamId))
+    {
+        const auto numRead = stream->output.read (channels, numFrames);
+
+        if (stream->output.takeWakeUpRequest())
+            sendWakeUp (streamId);
+
+        return numRead;
+    }
+
+    return 0;
+}
+
+void AtticServiceClient::sendWakeUp (int streamId)
+{
+    // The stream's worker has gone to sleep. Only sent when it asked for it, so an idle
+    // service isn't woken at all and a busy one doesn't get a message per block..
+    juce::ValueTree command ("wake");
+    command.setProperty ("stream", streamId, nullptr);
+
+    juce::MemoryOutputStream out;
+    command.writeToStream (out);
+    sendMessage (out.getMemoryBlock());
+}
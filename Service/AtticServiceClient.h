@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    AtticServiceClient.h
+
+    A minimal, blocking client for AtticService: it sends control commands
+    over the local socket and moves audio through the rings the service
+    hands back. It stands in for a real broadcast client when testing the
+    service..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AtticAudioRing.h"
+
+//==============================================================================
+/**
+*/
+class AtticServiceClient  : private juce::InterprocessConnection
+{
+public:
+    //==============================================================================
+    AtticServiceClient();
+    ~AtticServiceClient() override;
+
+    bool connect (int port, int timeoutMs = 2000);
+    void disconnect();
+
+    // Returns the new stream's id, or -1 if the service refused it..
+    int createStream (int numChannels, double sampleRate, int blockSize, int capacity = 0);
+    bool destroyStream (int streamId);
+
+    bool setParameter (int streamId, const juce::String& parameterId, float value);
+    bool getState (int streamId, juce::MemoryBlock& state);
+    bool setState (int streamId, const juce::MemoryBlock& state);
+    bool shutdownService();
+
+    // Audio for a stream; both return the number of frames actually moved..
+    int push (int streamId, const float* const* channels, int numFrames);
+    int pull (int streamId, float* const* channels, int numFrames);
+
+    const juce::String& getLastError() const noexcept     { return lastError; }
+
+private:
+    //==============================================================================
+    struct StreamRings
+    {
+        int id = 0;
+        AtticAudioRing input, output;
+    };
+
+    void connectionMade() override {}
+    void connectionLost() override;
+    void messageReceived (const juce::MemoryBlock& message) override;
+
+    // Sends a command and waits for the service's reply. Returns an invalid tree on timeout..
+    juce::ValueTree sendCommand (const juce::ValueTree& command);
+    StreamRings* findStream (int streamId) const;
+    void sendWakeUp (int streamId);
+
+    juce::OwnedArray<StreamRings> streams;
+    juce::CriticalSection replyLock;
+    juce::WaitableEvent replyReceived;
+    juce::ValueTree lastReply;
+    juce::String lastError;
+
+    static constexpr int replyTimeoutMs = 5000;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticServiceClient)
+};
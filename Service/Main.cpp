@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+
+    Entry point of the headless Attic service.
+
+    AtticService [--port=51730] [--workers=2] [--cores=2,3] [--rings=<dir>] [--selftest]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AtticService.h"
+#include "AtticServiceClient.h"
+
+//==============================================================================
+namespace
+{
+    // Plays the part of a broadcast client against a service running in this process: a couple of
+    // streams are created, driven with a sine, retuned and have their state round-tripped..
+    class SelfTest  : public juce::Thread
+    {
+    public:
+        explicit SelfTest (int portToUse)
+            : juce::Thread ("Attic self-test"), port (portToUse)
+        {
+        }
+
+        ~SelfTest() override
+        {
+            stopThread (5000);
+        }
+
+        void run() override
+        {
+            passed = runTest();
+            juce::MessageManager::callAsync ([] { juce::MessageManager::getInstance()->stopDispatchLoop(); });
+        }
+
+        bool hasPassed() const noexcept     { return passed.load(); }
+
+    private:
+        bool fail (const juce::String& message)
+        {
+            std::cerr << "Self-test failed: " << message << std::endl;
+            return false;
+        }
+
+        bool runTest()
+        {
+            static constexpr int numStreams = 4, numChannels = 2, blockSize = 256, numBlocks = 64;
+            static constexpr double sampleRate = 48000.0;
+
+            AtticServiceClient client;
+
+            if (! client.connect (port))
+                return fail ("couldn't connect to the service");
+
+            juce::Array<int> ids;
+
+            for (int i = 0; i < numStreams; ++i)
+            {
+                const auto id = client.createStream (numChannels, sampleRate, blockSize);
+
+                if (id < 0)
+                    return fail (client.getLastError());
+
+                if (! client.setParameter (id, "cutoff", 500.0f + 1000.0f * (float) i))
+                    return fail (client.getLastError());
+
+                ids.add (id);
+            }
+
+            juce::AudioBuffer<float> in (numChannels, blockSize), out (numChannels, blockSize);
+            double phase = 0.0;
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int n = 0; n < blockSize; ++n, phase += 440.0 / sampleRate)
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        in.setSample (channel, n, (float) std::sin (juce::MathConstants<double>::twoPi * phase));
+
+                for (auto id : ids)
+                {
+                    if (client.push (id, in.getArrayOfReadPointers(), blockSize) != blockSize)
+                        return fail ("input ring overflowed");
+
+                    auto received = 0;
+
+                    for (int attempt = 0; attempt < 1000 && received < blockSize; ++attempt)
+                    {
+                        juce::AudioBuffer<float> part (out.getArrayOfWritePointers(), numChannels, received, blockSize - received);
+                        received += client.pull (id, part.getArrayOfWritePointers(), blockSize - received);
+
+                        if (received < blockSize)
+                            juce::Thread::sleep (1);
+                    }
+
+                    if (received < blockSize)
+                        return fail ("timed out waiting for stream " + juce::String (id));
+
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        for (int n = 0; n < blockSize; ++n)
+                            if (! std::isfinite (out.getSample (channel, n)))
+                                return fail ("stream " + juce::String (id) + " produced a non-finite sample");
+
+                    if (block == numBlocks - 1 && out.getMagnitude (0, blockSize) < 1.0e-3f)
+                        return fail ("stream " + juce::String (id) + " is silent");
+                }
+            }
+
+            juce::MemoryBlock state;
+
+            if (! client.getState (ids.getFirst(), state) || ! client.setState (ids.getLast(), state))
+                return fail ("state round trip: " + client.getLastError());
+
+            for (auto id : ids)
+                if (! client.destroyStream (id))
+                    return fail (client.getLastError());
+
+            std::cout << "Self-test passed: " << numStreams << " streams, " << numBlocks << " blocks each" << std::endl;
+            return true;
+        }
+
+        const int port;
+        std::atomic<bool> passed { false };
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    AtticService::Options options;
+
+    if (args.containsOption ("--port"))
+        options.port = args.getValueForOption ("--port").getIntValue();
+
+    if (args.containsOption ("--workers"))
+        options.numWorkers = args.getValueForOption ("--workers").getIntValue();
+
+    if (args.containsOption ("--cores"))
+    {
+        for (auto& token : juce::StringArray::fromTokens (args.getValueForOption ("--cores"), ",", {}))
+        {
+            const auto core = token.trim();
+
+            // Anything but a plain number would otherwise quietly be read as core 0..
+            if (core.isEmpty() || ! core.containsOnly ("0123456789") || core.length() > 9)
+            {
+                std::cerr << "Invalid core \"" << core << "\" in --cores" << std::endl;
+                return 1;
+            }
+
+            options.cores.add (core.getIntValue());
+        }
+    }
+
+    if (args.containsOption ("--rings"))
+        options.ringDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--rings"));
+
+    AtticService service (options);
+    const auto started = service.start();
+
+    if (started.failed())
+    {
+        std::cerr << started.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    if (args.containsOption ("--selftest"))
+    {
+        SelfTest selfTest (options.port);
+        selfTest.startThread();
+        juce::MessageManager::getInstance()->runDispatchLoop();
+        service.stop();
+        return selfTest.hasPassed() ? 0 : 1;
+    }
+
+    std::cout << "Attic service listening on port " << options.port << std::endl;
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    AtticArena.h
+
+    Per-instance storage: one contiguous, cache-line aligned allocation which
+    an object carves into the regions holding its state and scratch, so that
+    they sit next to each other in memory rather than in separate heap
+    blocks..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Lay the regions out with add(), call allocate(), then fetch them with get()..
+*/
+class AtticArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    // Frees the allocation and forgets every region..
+    void clear() noexcept                                   { size = 0; block.free(); base = nullptr; }
+
+    // Returns the offset of a new region of count Ts, starting on a cache line..
+    template <typename T>
+    size_t add (size_t count) noexcept
+    {
+        const auto offset = (size + alignment - 1) & ~(alignment - 1);
+        size = offset + count * sizeof (T);
+        return offset;
+    }
+
+    // Allocates (and zeroes) everything added so far..
+    void allocate()
+    {
+        block.calloc (size + alignment);
+        base = reinterpret_cast<char*> ((reinterpret_cast<juce::pointer_sized_uint> (block.get()) + alignment - 1) & ~(juce::pointer_sized_uint) (alignment - 1));
+    }
+
+    template <typename T>
+    T* get (size_t offset) const noexcept                   { return reinterpret_cast<T*> (base + offset); }
+
+    size_t getSize() const noexcept                         { return base != nullptr ? size + alignment : 0; }
+
+private:
+    juce::HeapBlock<char> block;
+    char* base = nullptr;
+    size_t size = 0;
+};
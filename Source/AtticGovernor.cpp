@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    AtticGovernor.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticGovernor.h"
+
+//==============================================================================
+namespace
+{
+    constexpr double loadTimeConstantSeconds = 0.1;     // smoothing of the measured load
+    constexpr double settleSeconds = 0.25;              // wait after any change before judging the new level
+    constexpr double recoveryRatio = 0.5;               // headroom needed, as a share of the budget, before stepping up
+    constexpr double initialRecoveryHoldSeconds = 2.0;  // how long that headroom has to last..
+    constexpr double maximumRecoveryHoldSeconds = 32.0; // ..doubling up to this each time a recovery doesn't hold
+}
+
+//==============================================================================
+void AtticGovernor::prepare (double newSampleRate, int maximumLevel) noexcept
+{
+    jassert (newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    maxLevel = juce::jmax (0, maximumLevel);
+
+    smoothedLoad = 0.0;
+    secondsSinceChange = 0.0;
+    secondsWithHeadroom = 0.0;
+    recoveryHoldSeconds = initialRecoveryHoldSeconds;
+    lastChangeWasRecovery = false;
+
+    level = 0;
+    load = 0.0f;
+}
+
+void AtticGovernor::setMaximumLevel (int maximumLevel) noexcept
+{
+    maxLevel = juce::jmax (0, maximumLevel);
+
+    if (level.load() > maxLevel)
+        level = maxLevel;
+}
+
+//==============================================================================
+void AtticGovernor::update (juce::int64 startTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const auto blockSeconds = numSamples / sampleRate;
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+    const auto alpha = 1.0 - std::exp (-blockSeconds / loadTimeConstantSeconds);
+
+    smoothedLoad += alpha * (elapsedSeconds / blockSeconds - smoothedLoad);
+    load = (float) smoothedLoad;
+
+    secondsSinceChange += blockSeconds;
+
+    if (! enabled.load())
+    {
+        if (level.load() != 0)
+            changeLevel (0);
+
+        return;
+    }
+
+    const auto currentBudget = (double) budget.load();
+    const auto currentLevel = level.load();
+
+    if (smoothedLoad > currentBudget)
+    {
+        secondsWithHeadroom = 0.0;
+
+        if (currentLevel < maxLevel && secondsSinceChange >= settleSeconds)
+        {
+            // A recovery that ran straight back over budget makes the next one wait longer..
+            if (lastChangeWasRecovery && secondsSinceChange < recoveryHoldSeconds)
+                recoveryHoldSeconds = juce::jmin (recoveryHoldSeconds * 2.0, maximumRecoveryHoldSeconds);
+
+            changeLevel (currentLevel + 1);
+        }
+    }
+    else if (smoothedLoad < currentBudget * recoveryRatio)
+    {
+        secondsWithHeadroom += blockSeconds;
+
+        if (currentLevel > 0 && secondsWithHeadroom >= recoveryHoldSeconds && secondsSinceChange >= settleSeconds)
+            changeLevel (currentLevel - 1);
+    }
+    else
+    {
+        secondsWithHeadroom = 0.0;
+    }
+}
+
+void AtticGovernor::changeLevel (int newLevel) noexcept
+{
+    lastChangeWasRecovery = newLevel < level.load();
+    level = juce::jlimit (0, maxLevel, newLevel);
+    secondsSinceChange = 0.0;
+    secondsWithHeadroom = 0.0;
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    AtticGovernor.h
+
+    Keeps an instance within its share of the audio callback. Each block the
+    time spent in processBlock is compared with the block's real-time
+    deadline; when the smoothed load runs over budget the quality level is
+    stepped down, and it only climbs back once there has been headroom for a
+    while..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+*/
+class AtticGovernor
+{
+public:
+    //==============================================================================
+    AtticGovernor() = default;
+
+    // Called from prepareToPlay. Level 0 is full quality, maximumLevel the cheapest one..
+    void prepare (double sampleRate, int maximumLevel) noexcept;
+    void setMaximumLevel (int maximumLevel) noexcept;
+
+    void setEnabled (bool shouldBeEnabled) noexcept             { enabled = shouldBeEnabled; }
+    void setBudget (float newShareOfDeadline) noexcept          { budget = newShareOfDeadline; }
+
+    // Called at the end of every processBlock with the ticks it started at..
+    void update (juce::int64 startTicks, int numSamples) noexcept;
+
+    // Safe to call from any thread..
+    int getLevel() const noexcept                               { return level.load(); }
+    float getLoad() const noexcept                              { return load.load(); }
+
+private:
+    //==============================================================================
+    void changeLevel (int newLevel) noexcept;
+
+    double sampleRate = 44100.0;
+    int maxLevel = 0;
+
+    double smoothedLoad = 0.0;
+    double secondsSinceChange = 0.0, secondsWithHeadroom = 0.0;
+    double recoveryHoldSeconds = 0.0;
+    bool lastChangeWasRecovery = false;
+
+    std::atomic<bool> enabled { true };
+    std::atomic<float> budget { 0.1f };
+    std::atomic<int> level { 0 };
+    std::atomic<float> load { 0.0f };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticGovernor)
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    AtticLadder.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticLadder.h"
+
+//==============================================================================
+void AtticLadder::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    const auto numChannels = (int) spec.numChannels;
+
+    bank.prepare (spec.sampleRate, numChannels, (int) spec.maximumBlockSize);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        bank.setCutoffFrequencyHz (channel, cutoffFreqHz);
+        bank.setResonance (channel, resonance);
+        bank.setDrive (channel, drive);
+    }
+
+    bank.reset();
+}
+
+// Frees everything prepare() allocated, the parameters are kept for the next one..
+void AtticLadder::release() noexcept
+{
+    bank.release();
+}
+
+//==============================================================================
+void AtticLadder::setCutoffFrequencyHz (float newCutoff) noexcept
+{
+    cutoffFreqHz = newCutoff;
+
+    for (int channel = 0; channel < bank.getNumFilters(); ++channel)
+        bank.setCutoffFrequencyHz (channel, newCutoff);
+}
+
+void AtticLadder::setResonance (float newResonance) noexcept
+{
+    resonance = newResonance;
+
+    for (int channel = 0; channel < bank.getNumFilters(); ++channel)
+        bank.setResonance (channel, newResonance);
+}
+
+void AtticLadder::setDrive (float newDrive) noexcept
+{
+    drive = newDrive;
+
+    for (int channel = 0; channel < bank.getNumFilters(); ++channel)
+        bank.setDrive (channel, newDrive);
+}
+
+//==============================================================================
+void AtticLadder::process (const juce::dsp::ProcessContextReplacing<float>& context) noexcept
+{
+    const auto& inputBlock = context.getInputBlock();
+    auto& outputBlock = context.getOutputBlock();
+
+    if (context.isBypassed)
+    {
+        outputBlock.copyFrom (inputBlock);
+        return;
+    }
+
+    // One filter per channel, so the blocks go to the bank as they are..
+    bank.process (inputBlock, outputBlock);
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    AtticLadder.h
+
+    The ladder filter at the heart of Attic. The topology follows
+    juce::dsp::LadderFilter, but the two saturation stages (drive and resonance
+    feedback) can be switched between the original tanh lookup table and
+    first- or second-order antiderivative anti-aliasing (ADAA). It runs on an
+    AtticLadderBank with one filter per channel, all sharing one set of
+    parameters..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AtticLadderBank.h"
+
+//==============================================================================
+/**
+*/
+class AtticLadder
+{
+public:
+    using Mode = AtticLadderBank::Mode;
+    using Saturation = AtticLadderBank::Saturation;
+
+    //==============================================================================
+    AtticLadder() = default;
+
+    void prepare (const juce::dsp::ProcessSpec& spec);
+    void release() noexcept;
+    void reset() noexcept                                   { bank.reset(); }
+
+    void setMode (Mode newMode) noexcept                    { bank.setMode (newMode); }
+    void setCutoffFrequencyHz (float newCutoff) noexcept;
+    void setResonance (float newResonance) noexcept;
+    void setDrive (float newDrive) noexcept;
+    void setSaturation (Saturation newSaturation) noexcept  { bank.setSaturation (newSaturation); }
+
+    // Number of samples the smoothed cutoff and resonance are held for between updates..
+    void setControlInterval (int numSamples) noexcept       { bank.setControlInterval (numSamples); }
+
+    void process (const juce::dsp::ProcessContextReplacing<float>& context) noexcept;
+
+    // Bytes owned by this ladder, not counting the shared tables..
+    size_t getMemoryFootprint() const noexcept
+    {
+        return sizeof (*this) - sizeof (bank) + bank.getMemoryFootprint();
+    }
+
+private:
+    //==============================================================================
+    // Kept so that they can be handed to the bank again whenever it's re-prepared..
+    float cutoffFreqHz = 200.0f, resonance = 0.0f, drive = 1.2f;
+
+    AtticLadderBank bank;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR (AtticLadder)
+};
@@ -0,0 +1,834 @@
+/*
+  ==============================================================================
+
+    AtticLadderBank.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticLadderBank.h"
+
+//==============================================================================
+namespace
+{
+    constexpr double ln2 = 0.69314718055994530942;
+
+    // Below this spacing between inputs the divided differences become ill-conditioned
+    // and the ADAA stages fall back to evaluating the nonlinearity at the midpoint..
+    constexpr double adaaTolerance = 1.0e-5;
+
+    // Li2 (-u) for 0 <= u <= 1, from the Bernoulli series in w = -log (1 + u)..
+    inline double negativeDilogarithm (double u) noexcept
+    {
+        const auto w = -std::log1p (u);
+        const auto w2 = w * w;
+
+        return w - 0.25 * w2
+                 + w * w2 * (1.0 / 36.0
+                 + w2 * (-1.0 / 3600.0
+                 + w2 * (1.0 / 211680.0
+                 + w2 * (-1.0 / 10886400.0
+                 + w2 * (1.0 / 526901760.0
+                 + w2 * -4.0647616451442255e-11)))));
+    }
+
+    // First antiderivative of tanh, log (cosh (x)), written so that it cannot overflow..
+    inline double tanhAD1 (double x) noexcept
+    {
+        const auto a = std::abs (x);
+        return a + std::log1p (std::exp (-2.0 * a)) - ln2;
+    }
+
+    // Second antiderivative of tanh, the integral of log (cosh (t)) from 0 to x..
+    inline double tanhAD2 (double x) noexcept
+    {
+        const auto a = std::abs (x);
+        const auto g = 0.5 * a * a - a * ln2
+                     + 0.5 * negativeDilogarithm (std::exp (-2.0 * a))
+                     + juce::MathConstants<double>::pi * juce::MathConstants<double>::pi / 24.0;
+
+        return std::copysign (g, x);
+    }
+
+    inline double adaa1 (double x0, double x1, double ad1x0, double ad1x1) noexcept
+    {
+        const auto dx = x0 - x1;
+
+        return std::abs (dx) < adaaTolerance ? std::tanh (0.5 * (x0 + x1))
+                                             : (ad1x0 - ad1x1) / dx;
+    }
+
+    inline double firstDifference (double x0, double x1, double ad2x0, double ad2x1) noexcept
+    {
+        const auto dx = x0 - x1;
+
+        return std::abs (dx) < adaaTolerance ? tanhAD1 (0.5 * (x0 + x1))
+                                             : (ad2x0 - ad2x1) / dx;
+    }
+
+    inline double adaa2 (double x0, double x1, double x2, double ad2x1, double d1x0, double d1x1) noexcept
+    {
+        const auto dx = x0 - x2;
+
+        if (std::abs (dx) >= adaaTolerance)
+            return 2.0 * (d1x0 - d1x1) / dx;
+
+        const auto xBar = 0.5 * (x0 + x2);
+        const auto delta = xBar - x1;
+
+        if (std::abs (delta) < adaaTolerance)
+            return std::tanh (0.5 * (xBar + x1));
+
+        return (2.0 / delta) * (tanhAD1 (xBar) + (ad2x1 - tanhAD2 (xBar)) / delta);
+    }
+
+    // How much of the input is subtracted back out of the resonance feedback, per response..
+    template <AtticLadderBank::Mode mode>
+    constexpr float feedbackCompensation() noexcept
+    {
+        return (mode == AtticLadderBank::Mode::HPF12 || mode == AtticLadderBank::Mode::HPF24) ? 0.0f : 0.5f;
+    }
+
+    // Weights of the five ladder taps for each response, including the ladder's output gain of 1.2..
+    template <AtticLadderBank::Mode mode, typename Type>
+    inline Type mixStages (Type a, Type b, Type c, Type d, Type e) noexcept
+    {
+        if constexpr (mode == AtticLadderBank::Mode::LPF12)         return c * 1.2f;
+        else if constexpr (mode == AtticLadderBank::Mode::LPF24)    return e * 1.2f;
+        else if constexpr (mode == AtticLadderBank::Mode::HPF12)    return (a - b * 2.0f + c) * 1.2f;
+        else if constexpr (mode == AtticLadderBank::Mode::HPF24)    return (a - b * 4.0f + c * 6.0f - d * 4.0f + e) * 1.2f;
+        else if constexpr (mode == AtticLadderBank::Mode::BPF12)    return (d - c) * 1.2f;
+        else                                                        return (c - d * 2.0f + e) * 1.2f;
+    }
+}
+
+//==============================================================================
+void AtticLadderBank::Ramp::setTarget (int filter, float newTarget, int rampLength) noexcept
+{
+    if (newTarget == target[filter])
+        return;
+
+    target[filter] = newTarget;
+
+    if (rampLength <= 0)
+    {
+        snap (filter);
+        return;
+    }
+
+    remaining[filter] = (float) rampLength;
+    step[filter] = (newTarget - current[filter]) / (float) rampLength;
+}
+
+void AtticLadderBank::Ramp::snap (int filter) noexcept
+{
+    current[filter] = target[filter];
+    remaining[filter] = 0.0f;
+}
+
+AtticLadderBank::RampLanes AtticLadderBank::Ramp::load (int first) const noexcept
+{
+    return { Lanes::fromRawArray (current + first), Lanes::fromRawArray (target + first),
+             Lanes::fromRawArray (step + first), Lanes::fromRawArray (remaining + first) };
+}
+
+void AtticLadderBank::Ramp::store (int first, const RampLanes& lanes) noexcept
+{
+    lanes.current.copyToRawArray (current + first);
+    lanes.remaining.copyToRawArray (remaining + first);
+}
+
+AtticLadderBank::Lanes AtticLadderBank::RampLanes::advance (float numSteps) noexcept
+{
+    // Counted back from the target rather than accumulated, so that there's no branch
+    // for the filters which have arrived..
+    remaining = Lanes::max (remaining - numSteps, Lanes::expand (0.0f));
+    current = target - remaining * step;
+    return current;
+}
+
+void AtticLadderBank::PendingValues::set (int filter, float newValue) noexcept
+{
+    values[filter].store (newValue, std::memory_order_relaxed);
+    changed[filter].store (true, std::memory_order_release);
+}
+
+bool AtticLadderBank::PendingValues::take (int filter, float& value) noexcept
+{
+    if (! changed[filter].exchange (false, std::memory_order_acquire))
+        return false;
+
+    value = values[filter].load (std::memory_order_relaxed);
+    return true;
+}
+
+template <int count>
+void AtticLadderBank::FeedbackState::load (int first, FeedbackLanes& lanes) const noexcept
+{
+    for (int lane = 0; lane < count; ++lane)
+    {
+        lanes.x1[lane] = x1[first + lane];
+        lanes.x2[lane] = x2[first + lane];
+        lanes.ad1[lane] = ad1[first + lane];
+        lanes.ad2[lane] = ad2[first + lane];
+        lanes.d1[lane] = d1[first + lane];
+    }
+}
+
+template <int count>
+void AtticLadderBank::FeedbackState::store (int first, const FeedbackLanes& lanes) noexcept
+{
+    for (int lane = 0; lane < count; ++lane)
+    {
+        x1[first + lane] = lanes.x1[lane];
+        x2[first + lane] = lanes.x2[lane];
+        ad1[first + lane] = lanes.ad1[lane];
+        ad2[first + lane] = lanes.ad2[lane];
+        d1[first + lane] = lanes.d1[lane];
+    }
+}
+
+//==============================================================================
+void AtticLadderBank::prepare (double sampleRate, int newNumFilters, int maximumBlockSize)
+{
+    jassert (sampleRate > 0.0);
+    jassert (newNumFilters > 0 && maximumBlockSize > 0);
+
+    static constexpr double smootherRampTimeSec = 0.05;
+    cutoffFreqScaler = (float) (-2.0 * juce::MathConstants<double>::pi / sampleRate);
+    rampLength = (int) std::floor (smootherRampTimeSec * sampleRate);
+
+    numFilters = newNumFilters;
+    rowSize = (numFilters + numLanes - 1) / numLanes * numLanes;
+    chunkSize = juce::jmin (maximumBlockSize, maximumChunkSize);
+
+    const auto perFilter = (size_t) rowSize;
+    const auto rows = (size_t) (chunkSize + historyRows);
+
+    // Regions start on cache lines and rows are whole groups long, so every group's
+    // values can be loaded straight into a register..
+    static_assert (AtticArena::alignment % Lanes::SIMDRegisterSize == 0, "Arena regions must be SIMD aligned");
+
+    arena.clear();
+
+    size_t stageOffsets[5], rampOffsets[2][4], driveOffsets[4], feedbackOffsets[5], pendingOffsets[3][2];
+
+    for (auto& offset : stageOffsets)       offset = arena.add<float> (perFilter);
+    for (auto& ramp : rampOffsets)
+        for (auto& offset : ramp)           offset = arena.add<float> (perFilter);
+    for (auto& offset : driveOffsets)       offset = arena.add<float> (perFilter);
+    for (auto& offset : feedbackOffsets)    offset = arena.add<double> (perFilter);
+
+    for (auto& pending : pendingOffsets)
+    {
+        pending[0] = arena.add<std::atomic<float>> (perFilter);
+        pending[1] = arena.add<std::atomic<bool>> (perFilter);
+    }
+
+    const auto inputOffset = arena.add<float> (rows * perFilter);
+    const auto drivenOffset = arena.add<float> ((size_t) chunkSize * perFilter);
+    const auto outputOffset = arena.add<float> ((size_t) chunkSize * perFilter);
+    const auto argumentOffset = arena.add<double> (rows * perFilter);
+    const auto antiderivativeOffset = arena.add<double> (rows * perFilter);
+    const auto differenceOffset = arena.add<double> (rows * perFilter);
+    const auto inputPointersOffset = arena.add<const float*> (perFilter);
+    const auto outputPointersOffset = arena.add<float*> (perFilter);
+
+    arena.allocate();
+
+    for (int i = 0; i < 5; ++i)
+        stages[i] = arena.get<float> (stageOffsets[i]);
+
+    auto bindRamp = [this] (Ramp& ramp, const size_t* offsets)
+    {
+        ramp.current = arena.get<float> (offsets[0]);
+        ramp.target = arena.get<float> (offsets[1]);
+        ramp.step = arena.get<float> (offsets[2]);
+        ramp.remaining = arena.get<float> (offsets[3]);
+    };
+
+    bindRamp (cutoffTransform, rampOffsets[0]);
+    bindRamp (scaledResonance, rampOffsets[1]);
+
+    drive = arena.get<float> (driveOffsets[0]);
+    gain = arena.get<float> (driveOffsets[1]);
+    drive2 = arena.get<float> (driveOffsets[2]);
+    gain2 = arena.get<float> (driveOffsets[3]);
+
+    feedback.x1 = arena.get<double> (feedbackOffsets[0]);
+    feedback.x2 = arena.get<double> (feedbackOffsets[1]);
+    feedback.ad1 = arena.get<double> (feedbackOffsets[2]);
+    feedback.ad2 = arena.get<double> (feedbackOffsets[3]);
+    feedback.d1 = arena.get<double> (feedbackOffsets[4]);
+
+    auto bindPending = [this, perFilter] (PendingValues& pending, const size_t* offsets)
+    {
+        pending.values = arena.get<std::atomic<float>> (offsets[0]);
+        pending.changed = arena.get<std::atomic<bool>> (offsets[1]);
+
+        for (size_t filter = 0; filter < perFilter; ++filter)
+        {
+            new (pending.values + filter) std::atomic<float> (0.0f);
+            new (pending.changed + filter) std::atomic<bool> (false);
+        }
+    };
+
+    bindPending (pendingCutoff, pendingOffsets[0]);
+    bindPending (pendingResonance, pendingOffsets[1]);
+    bindPending (pendingDrive, pendingOffsets[2]);
+    parametersPending = false;
+
+    inputBuffer = arena.get<float> (inputOffset);
+    drivenBuffer = arena.get<float> (drivenOffset);
+    outputBuffer = arena.get<float> (outputOffset);
+    argumentBuffer = arena.get<double> (argumentOffset);
+    antiderivativeBuffer = arena.get<double> (antiderivativeOffset);
+    differenceBuffer = arena.get<double> (differenceOffset);
+    inputPointers = arena.get<const float*> (inputPointersOffset);
+    outputPointers = arena.get<float*> (outputPointersOffset);
+
+    // Same defaults as juce::dsp::LadderFilter..
+    for (int filter = 0; filter < numFilters; ++filter)
+    {
+        setCutoffFrequencyHz (filter, 200.0f);
+        setResonance (filter, 0.0f);
+        setDrive (filter, 1.2f);
+    }
+
+    reset();
+}
+
+void AtticLadderBank::release() noexcept
+{
+    // Every array lives in the arena, and none of them is touched again with no filters..
+    arena.clear();
+    numFilters = rowSize = chunkSize = 0;
+}
+
+void AtticLadderBank::reset() noexcept
+{
+    for (int filter = 0; filter < numFilters; ++filter)
+        reset (filter);
+}
+
+// A filter comes out of a reset at rest on its latest parameters, rather than gliding to them..
+void AtticLadderBank::reset (int filter) noexcept
+{
+    jassert (juce::isPositiveAndBelow (filter, numFilters));
+
+    applyPendingParameters (filter);
+
+    for (auto* stage : stages)
+        stage[filter] = 0.0f;
+
+    for (int row = 0; row < historyRows; ++row)
+        inputBuffer[row * rowSize + filter] = 0.0f;
+
+    cutoffTransform.snap (filter);
+    scaledResonance.snap (filter);
+    rebuildFeedback (filter);
+}
+
+//==============================================================================
+void AtticLadderBank::setMode (Mode newMode) noexcept
+{
+    // The response itself is compiled into the kernels, see mixStages()..
+    jassert (newMode >= Mode::LPF12 && newMode <= Mode::BPF24);
+    requestedMode.store (newMode, std::memory_order_relaxed);
+}
+
+void AtticLadderBank::setCutoffFrequencyHz (int filter, float newCutoff) noexcept
+{
+    jassert (juce::isPositiveAndBelow (filter, numFilters));
+    jassert (newCutoff > 0.0f);
+    pendingCutoff.set (filter, newCutoff);
+    parametersPending.store (true, std::memory_order_release);
+}
+
+void AtticLadderBank::setResonance (int filter, float newResonance) noexcept
+{
+    jassert (juce::isPositiveAndBelow (filter, numFilters));
+    jassert (newResonance >= 0.0f && newResonance <= 1.0f);
+    pendingResonance.set (filter, newResonance);
+    parametersPending.store (true, std::memory_order_release);
+}
+
+void AtticLadderBank::setDrive (int filter, float newDrive) noexcept
+{
+    jassert (juce::isPositiveAndBelow (filter, numFilters));
+    pendingDrive.set (filter, newDrive);
+    parametersPending.store (true, std::memory_order_release);
+}
+
+void AtticLadderBank::applyPendingParameters() noexcept
+{
+    // The flag is cleared before the filters are looked at, so a value set meanwhile
+    // is either taken now or flagged again for the next chunk..
+    if (! parametersPending.exchange (false, std::memory_order_acquire))
+        return;
+
+    for (int filter = 0; filter < numFilters; ++filter)
+        applyPendingParameters (filter);
+}
+
+void AtticLadderBank::applyPendingParameters (int filter) noexcept
+{
+    float value;
+
+    if (pendingCutoff.take (filter, value))
+        cutoffTransform.setTarget (filter, std::exp (value * cutoffFreqScaler), rampLength);
+
+    if (pendingResonance.take (filter, value))
+        scaledResonance.setTarget (filter, juce::jmap (value, 0.1f, 1.0f), rampLength);
+
+    if (pendingDrive.take (filter, value))
+        updateDrive (filter, value);
+}
+
+void AtticLadderBank::updateDrive (int filter, float newDrive) noexcept
+{
+    drive[filter] = juce::jmax (newDrive, 1.0f);
+    gain[filter] = std::pow (drive[filter], -2.642f) * 0.6103f + 0.3903f;
+    drive2[filter] = drive[filter] * 0.04f + 0.96f;
+    gain2[filter] = std::pow (drive2[filter], -2.642f) * 0.6103f + 0.3903f;
+}
+
+void AtticLadderBank::rebuildFeedback (int filter) noexcept
+{
+    // Restarts the saturator's history as if its input had been sitting at the current value,
+    // which its next input is. The ADAA stages then start out on their exact fallback, so a
+    // change of saturation is free of clicks..
+    const auto x = (double) (drive2[filter] * stages[4][filter]);
+
+    feedback.x1[filter] = x;
+    feedback.x2[filter] = x;
+    feedback.ad1[filter] = tanhAD1 (x);
+    feedback.ad2[filter] = tanhAD2 (x);
+    feedback.d1[filter] = tanhAD1 (x);
+}
+
+//==============================================================================
+void AtticLadderBank::process (const float* const* inputs, float* const* outputs, int numSamples) noexcept
+{
+    // A new mode resets the filters, which takes their pending parameters with it..
+    const auto newMode = requestedMode.load (std::memory_order_relaxed);
+
+    if (newMode != mode)
+    {
+        mode = newMode;
+        reset();
+    }
+
+    // New parameters come first, so that a new saturation starts from the drive it's heard with..
+    applyPendingParameters();
+
+    // A new saturation takes effect at the start of a block..
+    if (activeSaturation != saturation)
+    {
+        for (int filter = 0; filter < numFilters; ++filter)
+            rebuildFeedback (filter);
+
+        activeSaturation = saturation;
+    }
+
+    auto* newRows = inputBuffer + historyRows * rowSize;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto chunk = juce::jmin (chunkSize, numSamples - start);
+
+        // The kernels hold the ramps for the whole chunk, so new targets are only taken in between..
+        if (start > 0)
+            applyPendingParameters();
+
+        for (int filter = 0; filter < numFilters; ++filter)
+        {
+            const auto* input = inputs[filter] + start;
+
+            for (int n = 0; n < chunk; ++n)
+                newRows[n * rowSize + filter] = input[n];
+        }
+
+        // Picks the kernel once per chunk, so there's no branching on any of these per sample..
+        switch (activeSaturation)
+        {
+            case Saturation::ADAA1:     processMode<Saturation::ADAA1>  (chunk); break;
+            case Saturation::ADAA2:     processMode<Saturation::ADAA2>  (chunk); break;
+            case Saturation::Exact:     processMode<Saturation::Exact>  (chunk); break;
+            case Saturation::Lookup:
+            default:                    processMode<Saturation::Lookup> (chunk); break;
+        }
+
+        for (int filter = 0; filter < numFilters; ++filter)
+        {
+            auto* output = outputs[filter] + start;
+
+            for (int n = 0; n < chunk; ++n)
+                output[n] = outputBuffer[n * rowSize + filter];
+        }
+
+        std::memmove (inputBuffer, inputBuffer + chunk * rowSize, (size_t) (historyRows * rowSize) * sizeof (float));
+    }
+}
+
+void AtticLadderBank::process (const juce::dsp::AudioBlock<const float>& inputBlock, juce::dsp::AudioBlock<float>& outputBlock) noexcept
+{
+    jassert (inputBlock.getNumChannels() == (size_t) numFilters);
+    jassert (outputBlock.getNumChannels() == (size_t) numFilters);
+    jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+    for (int filter = 0; filter < numFilters; ++filter)
+    {
+        inputPointers[filter] = inputBlock.getChannelPointer ((size_t) filter);
+        outputPointers[filter] = outputBlock.getChannelPointer ((size_t) filter);
+    }
+
+    process (inputPointers, outputPointers, (int) outputBlock.getNumSamples());
+}
+
+template <AtticLadderBank::Saturation sat>
+void AtticLadderBank::processMode (int numSamples) noexcept
+{
+    // With a fixed count the drive stage's loops over the filters go away for mono and stereo..
+    switch (numFilters)
+    {
+        case 1:     saturateDriveStage<sat, 1> (numSamples); break;
+        case 2:     saturateDriveStage<sat, 2> (numSamples); break;
+        default:    saturateDriveStage<sat, 0> (numSamples); break;
+    }
+
+    switch (mode)
+    {
+        case Mode::LPF12:   processFilters<Mode::LPF12, sat> (numSamples); break;
+        case Mode::LPF24:   processFilters<Mode::LPF24, sat> (numSamples); break;
+        case Mode::HPF12:   processFilters<Mode::HPF12, sat> (numSamples); break;
+        case Mode::HPF24:   processFilters<Mode::HPF24, sat> (numSamples); break;
+        case Mode::BPF12:   processFilters<Mode::BPF12, sat> (numSamples); break;
+        case Mode::BPF24:   processFilters<Mode::BPF24, sat> (numSamples); break;
+        default:            jassertfalse; break;
+    }
+}
+
+template <AtticLadderBank::Mode m, AtticLadderBank::Saturation sat>
+void AtticLadderBank::processFilters (int numSamples) noexcept
+{
+    if (numFilters == 1)    { processSingly<m, sat, 1> (numSamples); return; }
+    if (numFilters == 2)    { processSingly<m, sat, 2> (numSamples); return; }
+
+    // As many groups per pass as there are left. The lanes past the last filter hold zeros,
+    // which saturate to zero, so every lane can be treated alike..
+    const auto numGroups = rowSize / numLanes;
+    auto group = 0;
+
+    for (; group + maximumGroupsPerPass <= numGroups; group += maximumGroupsPerPass)
+        processGroups<m, sat, maximumGroupsPerPass> (group * numLanes, numSamples);
+
+    if (group + 2 <= numGroups)
+    {
+        processGroups<m, sat, 2> (group * numLanes, numSamples);
+        group += 2;
+    }
+
+    if (group < numGroups)
+        processGroups<m, sat, 1> (group * numLanes, numSamples);
+}
+
+template <AtticLadderBank::Mode m, AtticLadderBank::Saturation sat, int numGroups>
+void AtticLadderBank::processGroups (int first, int numSamples) noexcept
+{
+    // The groups' state, ramps and saturator history stay in registers (or at least on the
+    // stack) for the whole chunk. The loops over the groups have a fixed trip count, so they
+    // unroll into independent instruction streams..
+    constexpr auto hasHistory = sat == Saturation::ADAA1 || sat == Saturation::ADAA2;
+
+    Lanes s[numGroups][5], d2[numGroups], g2[numGroups];
+    Lanes a1[numGroups], b0[numGroups], b1[numGroups], k[numGroups];
+    RampLanes cutoff[numGroups], res[numGroups];
+    FeedbackLanes history[numGroups];
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        const auto offset = first + group * numLanes;
+
+        for (int i = 0; i < 5; ++i)
+            s[group][i] = Lanes::fromRawArray (stages[i] + offset);
+
+        d2[group] = Lanes::fromRawArray (drive2 + offset);
+        g2[group] = Lanes::fromRawArray (gain2 + offset);
+        cutoff[group] = cutoffTransform.load (offset);
+        res[group] = scaledResonance.load (offset);
+
+        if constexpr (hasHistory)
+            feedback.load<numLanes> (offset, history[group]);
+    }
+
+    for (int n = 0; n < numSamples; n += controlInterval)
+    {
+        const auto held = juce::jmin (controlInterval, numSamples - n);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            a1[group] = cutoff[group].advance ((float) held);
+
+            const auto g = Lanes::expand (1.0f) - a1[group];
+            b0[group] = g * 0.76923076923f;
+            b1[group] = g * 0.23076923076f;
+            k[group] = res[group].advance ((float) held) * -4.0f;
+        }
+
+        for (int i = n; i < n + held; ++i)
+        {
+            for (int group = 0; group < numGroups; ++group)
+            {
+                const auto offset = i * rowSize + first + group * numLanes;
+                auto* st = s[group];
+
+                const auto dx = Lanes::fromRawArray (drivenBuffer + offset);
+                const auto a = dx + k[group] * (g2[group] * saturateFeedback<sat> (d2[group] * st[4], history[group])
+                                                  - dx * feedbackCompensation<m>());
+
+                const auto b = b1[group] * st[0] + a1[group] * st[1] + b0[group] * a;
+                const auto c = b1[group] * st[1] + a1[group] * st[2] + b0[group] * b;
+                const auto d = b1[group] * st[2] + a1[group] * st[3] + b0[group] * c;
+                const auto e = b1[group] * st[3] + a1[group] * st[4] + b0[group] * d;
+
+                st[0] = a;
+                st[1] = b;
+                st[2] = c;
+                st[3] = d;
+                st[4] = e;
+
+                mixStages<m> (a, b, c, d, e).copyToRawArray (outputBuffer + offset);
+            }
+        }
+    }
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        const auto offset = first + group * numLanes;
+
+        for (int i = 0; i < 5; ++i)
+            s[group][i].copyToRawArray (stages[i] + offset);
+
+        cutoffTransform.store (offset, cutoff[group]);
+        scaledResonance.store (offset, res[group]);
+
+        if constexpr (hasHistory)
+            feedback.store<numLanes> (offset, history[group]);
+    }
+}
+
+template <AtticLadderBank::Mode m, AtticLadderBank::Saturation sat, int count>
+void AtticLadderBank::processSingly (int numSamples) noexcept
+{
+    // A group would leave most of its lanes idle here, and every sample's saturated lanes
+    // would have to go back into a register through memory, right in the middle of the
+    // feedback loop. So this keeps each filter in scalars, with a fixed trip count over the
+    // filters so that their recurrences overlap. The arithmetic is the same as processGroups()..
+    constexpr auto hasHistory = sat == Saturation::ADAA1 || sat == Saturation::ADAA2;
+
+    float s[count][5], d2[count], g2[count];
+    float a1[count], b0[count], b1[count], k[count];
+    float cutoffLeft[count], res[count], resLeft[count];
+    FeedbackLanes history;
+
+    for (int f = 0; f < count; ++f)
+    {
+        for (int i = 0; i < 5; ++i)
+            s[f][i] = stages[i][f];
+
+        d2[f] = drive2[f];
+        g2[f] = gain2[f];
+        a1[f] = cutoffTransform.current[f];
+        cutoffLeft[f] = cutoffTransform.remaining[f];
+        res[f] = scaledResonance.current[f];
+        resLeft[f] = scaledResonance.remaining[f];
+    }
+
+    if constexpr (hasHistory)
+        feedback.load<count> (0, history);
+
+    for (int n = 0; n < numSamples; n += controlInterval)
+    {
+        const auto held = juce::jmin (controlInterval, numSamples - n);
+
+        for (int f = 0; f < count; ++f)
+        {
+            cutoffLeft[f] = juce::jmax (cutoffLeft[f] - (float) held, 0.0f);
+            a1[f] = cutoffTransform.target[f] - cutoffLeft[f] * cutoffTransform.step[f];
+            resLeft[f] = juce::jmax (resLeft[f] - (float) held, 0.0f);
+            res[f] = scaledResonance.target[f] - resLeft[f] * scaledResonance.step[f];
+
+            const auto g = 1.0f - a1[f];
+            b0[f] = g * 0.76923076923f;
+            b1[f] = g * 0.23076923076f;
+            k[f] = res[f] * -4.0f;
+        }
+
+        for (int i = n; i < n + held; ++i)
+        {
+            for (int f = 0; f < count; ++f)
+            {
+                const auto offset = i * rowSize + f;
+                auto* st = s[f];
+
+                const auto dx = drivenBuffer[offset];
+                const auto a = dx + k[f] * (g2[f] * saturateFeedback<sat> (d2[f] * st[4], history, f)
+                                              - dx * feedbackCompensation<m>());
+
+                const auto b = b1[f] * st[0] + a1[f] * st[1] + b0[f] * a;
+                const auto c = b1[f] * st[1] + a1[f] * st[2] + b0[f] * b;
+                const auto d = b1[f] * st[2] + a1[f] * st[3] + b0[f] * c;
+                const auto e = b1[f] * st[3] + a1[f] * st[4] + b0[f] * d;
+
+                st[0] = a;
+                st[1] = b;
+                st[2] = c;
+                st[3] = d;
+                st[4] = e;
+
+                outputBuffer[offset] = mixStages<m> (a, b, c, d, e);
+            }
+        }
+    }
+
+    for (int f = 0; f < count; ++f)
+    {
+        for (int i = 0; i < 5; ++i)
+            stages[i][f] = s[f][i];
+
+        cutoffTransform.current[f] = a1[f];
+        cutoffTransform.remaining[f] = cutoffLeft[f];
+        scaledResonance.current[f] = res[f];
+        scaledResonance.remaining[f] = resLeft[f];
+    }
+
+    if constexpr (hasHistory)
+        feedback.store<count> (0, history);
+}
+
+template <AtticLadderBank::Saturation sat>
+AtticLadderBank::Lanes AtticLadderBank::saturateFeedback (Lanes x, FeedbackLanes& history) noexcept
+{
+    // Like the drive stage, this goes lane by lane..
+    alignas (Lanes::SIMDRegisterSize) float values[numLanes];
+    x.copyToRawArray (values);
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        values[lane] = saturateFeedback<sat> (values[lane], history, lane);
+
+    return Lanes::fromRawArray (values);
+}
+
+template <AtticLadderBank::Saturation sat>
+float AtticLadderBank::saturateFeedback (float x, FeedbackLanes& history, int lane) noexcept
+{
+    if constexpr (sat == Saturation::Lookup)
+    {
+        return tables->tanhTable (x);
+    }
+    else if constexpr (sat == Saturation::Exact)
+    {
+        return std::tanh (x);
+    }
+    else
+    {
+        // The ADAA states are updated in double, through the scalar helpers above..
+        const auto x0 = (double) x;
+        double y;
+
+        if constexpr (sat == Saturation::ADAA1)
+        {
+            const auto ad1 = tanhAD1 (x0);
+            y = adaa1 (x0, history.x1[lane], ad1, history.ad1[lane]);
+            history.ad1[lane] = ad1;
+        }
+        else
+        {
+            const auto ad2 = tanhAD2 (x0);
+            const auto d1 = firstDifference (x0, history.x1[lane], ad2, history.ad2[lane]);
+            y = adaa2 (x0, history.x1[lane], history.x2[lane], history.ad2[lane], d1, history.d1[lane]);
+            history.ad2[lane] = ad2;
+            history.d1[lane] = d1;
+        }
+
+        history.x2[lane] = history.x1[lane];
+        history.x1[lane] = x0;
+        return (float) y;
+    }
+}
+
+template <AtticLadderBank::Saturation sat, int fixedCount>
+void AtticLadderBank::saturateDriveStage (int numSamples) noexcept
+{
+    const auto count = fixedCount > 0 ? fixedCount : numFilters;
+    const auto* input = inputBuffer + historyRows * rowSize;
+
+    if constexpr (sat == Saturation::Lookup || sat == Saturation::Exact)
+    {
+        const auto& table = tables->tanhTable;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            const auto* x = input + n * rowSize;
+            auto* y = drivenBuffer + n * rowSize;
+
+            for (int f = 0; f < count; ++f)
+                y[f] = gain[f] * (sat == Saturation::Exact ? std::tanh (drive[f] * x[f])
+                                                           : table (drive[f] * x[f]));
+        }
+    }
+    else
+    {
+        // Each row only looks back at earlier rows, with the history rows in front of the
+        // chunk standing in for the previous one, so every antiderivative is evaluated once
+        // per sample. These loops still run scalar: the antiderivatives call std::exp and
+        // std::log1p in double, and the ill-conditioned fallbacks branch to std::tanh..
+        const auto numRows = numSamples + historyRows;
+        auto* args = argumentBuffer;
+        auto* ad = antiderivativeBuffer;
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            for (int f = 0; f < count; ++f)
+            {
+                const auto i = row * rowSize + f;
+                args[i] = (double) (drive[f] * inputBuffer[i]);
+                ad[i] = sat == Saturation::ADAA1 ? tanhAD1 (args[i]) : tanhAD2 (args[i]);
+            }
+        }
+
+        if constexpr (sat == Saturation::ADAA1)
+        {
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const auto i = (n + historyRows) * rowSize;
+
+                for (int f = 0; f < count; ++f)
+                    drivenBuffer[n * rowSize + f] = gain[f] * (float) adaa1 (args[i + f], args[i + f - rowSize],
+                                                                             ad[i + f], ad[i + f - rowSize]);
+            }
+        }
+        else
+        {
+            auto* diff = differenceBuffer;
+
+            for (int row = 1; row < numRows; ++row)
+            {
+                const auto i = row * rowSize;
+
+                for (int f = 0; f < count; ++f)
+                    diff[i + f] = firstDifference (args[i + f], args[i + f - rowSize], ad[i + f], ad[i + f - rowSize]);
+            }
+
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const auto i = (n + historyRows) * rowSize;
+
+                for (int f = 0; f < count; ++f)
+                    drivenBuffer[n * rowSize + f] = gain[f] * (float) adaa2 (args[i + f], args[i + f - rowSize], args[i + f - 2 * rowSize],
+                                                                             ad[i + f - rowSize], diff[i + f], diff[i + f - rowSize]);
+            }
+        }
+    }
+}
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    AtticLadderBank.h
+
+    Any number of independent Attic ladder filters, processed together, e.g.
+    one per voice of a sampler. Each filter has its own cutoff, resonance and
+    drive, while the response and the saturation are shared by the bank.
+    Every field of the filters' state is kept in its own array, and the
+    kernel steps a group of filters through each sample at once, one per
+    lane of a juce::dsp::SIMDRegister, so that the ladder stages are
+    vectorised across filters rather than across samples. The saturators
+    (the lookup table, std::tanh and the ADAA antiderivatives) are evaluated
+    one filter at a time. Banks of one or two filters, such as a mono or
+    stereo AtticLadder, don't fill a group and run a scalar kernel instead..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AtticSharedTables.h"
+#include "AtticArena.h"
+
+//==============================================================================
+/**
+    prepare(), release(), reset(), process(), setSaturation() and setControlInterval()
+    belong to the audio thread. setMode() and the per-filter setters may be called from
+    any thread while the bank is prepared, though not during prepare() or release():
+    they only leave the new value for process() to pick up, the mode at the start of
+    the next block and the filters' parameters at the start of the next chunk..
+*/
+class AtticLadderBank
+{
+public:
+    // Same order as the entries of the "mode" parameter..
+    enum class Mode
+    {
+        LPF12 = 0,
+        LPF24,
+        HPF12,
+        HPF24,
+        BPF12,
+        BPF24
+    };
+
+    // The first three follow the entries of the "antialias" parameter..
+    enum class Saturation
+    {
+        Lookup = 0, // tanh lookup table, as used by juce::dsp::LadderFilter
+        ADAA1,      // first-order antiderivative anti-aliasing
+        ADAA2,      // second-order antiderivative anti-aliasing
+        Exact       // std::tanh, only used by the offline render tiers
+    };
+
+    //==============================================================================
+    AtticLadderBank() = default;
+
+    // Allocates numFilters filters and returns each of them to juce::dsp::LadderFilter's defaults..
+    void prepare (double sampleRate, int numFilters, int maximumBlockSize);
+
+    // Frees the filters' state, leaving a bank of no filters until the next prepare()..
+    void release() noexcept;
+
+    void reset() noexcept;
+    void reset (int filter) noexcept;
+
+    int getNumFilters() const noexcept                      { return numFilters; }
+
+    // The new response starts from a reset at the next process()..
+    void setMode (Mode newMode) noexcept;
+    void setSaturation (Saturation newSaturation) noexcept  { saturation = newSaturation; }
+
+    // Number of samples the smoothed cutoff and resonance are held for between updates..
+    void setControlInterval (int numSamples) noexcept       { controlInterval = juce::jmax (1, numSamples); }
+
+    void setCutoffFrequencyHz (int filter, float newCutoff) noexcept;
+    void setResonance (int filter, float newResonance) noexcept;
+    void setDrive (int filter, float newDrive) noexcept;
+
+    // Runs numSamples through every filter: filter i reads inputs[i] and writes outputs[i],
+    // which may point to the same samples..
+    void process (const float* const* inputs, float* const* outputs, int numSamples) noexcept;
+
+    // The same for blocks with one channel per filter, gathering their channels' pointers
+    // in the bank's own arena..
+    void process (const juce::dsp::AudioBlock<const float>& inputBlock, juce::dsp::AudioBlock<float>& outputBlock) noexcept;
+
+    size_t getMemoryFootprint() const noexcept              { return sizeof (*this) + arena.getSize(); }
+
+private:
+    //==============================================================================
+    // Filters are stepped in groups, one per lane of a SIMD register..
+    using Lanes = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = (int) Lanes::SIMDNumElements;
+
+    // Each sample of a group is one long chain of dependent operations, so the kernel
+    // interleaves up to this many independent groups to keep the pipeline busy..
+    static constexpr int maximumGroupsPerPass = 4;
+
+    // Inputs are processed in chunks of at most this many samples, so the scratch
+    // stays in cache however many filters there are..
+    static constexpr int maximumChunkSize = 128;
+
+    // Drive stage inputs kept from the previous chunk, for the antiderivative differences..
+    static constexpr int historyRows = 2;
+
+    // One group's ramps, held in registers by the kernels for the length of a chunk..
+    struct RampLanes
+    {
+        Lanes current, target, step, remaining;
+
+        // Moves the group on by numSteps samples and returns its new values..
+        Lanes advance (float numSteps) noexcept;
+    };
+
+    // A linear ramp per filter, with the same timing as juce::SmoothedValue..
+    struct Ramp
+    {
+        float* current = nullptr;
+        float* target = nullptr;
+        float* step = nullptr;
+        float* remaining = nullptr;
+
+        void setTarget (int filter, float newTarget, int rampLength) noexcept;
+        void snap (int filter) noexcept;
+
+        RampLanes load (int first) const noexcept;
+        void store (int first, const RampLanes& lanes) noexcept;
+    };
+
+    // The latest value each filter was given by a setter, waiting for the audio thread..
+    struct PendingValues
+    {
+        std::atomic<float>* values = nullptr;
+        std::atomic<bool>* changed = nullptr;
+
+        void set (int filter, float newValue) noexcept;
+
+        // Returns false if there's been nothing new for the filter since the last call..
+        bool take (int filter, float& value) noexcept;
+    };
+
+    // One group's feedback saturator history, held by the kernels for the length of a chunk..
+    struct FeedbackLanes
+    {
+        double x1[numLanes], x2[numLanes], ad1[numLanes], ad2[numLanes], d1[numLanes];
+    };
+
+    // History of the feedback saturators, per filter..
+    struct FeedbackState
+    {
+        double* x1 = nullptr;       // previous two inputs
+        double* x2 = nullptr;
+        double* ad1 = nullptr;      // first antiderivative at x1
+        double* ad2 = nullptr;      // second antiderivative at x1
+        double* d1 = nullptr;       // last first-order divided difference of the second antiderivative
+
+        // Copies count filters from first on to or from a kernel's working copy..
+        template <int count>
+        void load (int first, FeedbackLanes& lanes) const noexcept;
+
+        template <int count>
+        void store (int first, const FeedbackLanes& lanes) noexcept;
+    };
+
+    template <Saturation sat>
+    void processMode (int numSamples) noexcept;
+
+    template <Mode m, Saturation sat>
+    void processFilters (int numSamples) noexcept;
+
+    template <Mode m, Saturation sat, int numGroups>
+    void processGroups (int first, int numSamples) noexcept;
+
+    // Mono and stereo banks, which don't fill a group, step each filter's scalar recurrence..
+    template <Mode m, Saturation sat, int count>
+    void processSingly (int numSamples) noexcept;
+
+    // fixedCount is the number of filters when the kernel knows it at compile time, else 0..
+    template <Saturation sat, int fixedCount>
+    void saturateDriveStage (int numSamples) noexcept;
+
+    template <Saturation sat>
+    Lanes saturateFeedback (Lanes x, FeedbackLanes& history) noexcept;
+
+    template <Saturation sat>
+    float saturateFeedback (float x, FeedbackLanes& history, int lane) noexcept;
+
+    void rebuildFeedback (int filter) noexcept;
+
+    // Hands the setters' latest values to the ramps and the drive stage..
+    void applyPendingParameters() noexcept;
+    void applyPendingParameters (int filter) noexcept;
+    void updateDrive (int filter, float newDrive) noexcept;
+
+    //==============================================================================
+    juce::SharedResourcePointer<AtticSharedTables> tables;
+
+    Mode mode = Mode::LPF12;
+    std::atomic<Mode> requestedMode { Mode::LPF12 };
+    Saturation saturation = Saturation::Lookup, activeSaturation = Saturation::Lookup;
+    int numFilters = 0, rowSize = 0, chunkSize = 0, rampLength = 0, controlInterval = 1;
+    float cutoffFreqScaler = 0.0f;
+
+    // One array per field, all carved out of the arena in prepare(). They're rowSize long,
+    // numFilters rounded up to whole groups; the filters past numFilters stay all zeros,
+    // which is silent and stable..
+    AtticArena arena;
+    float* stages[5] = {};                          // ladder stage outputs, stages[4] feeds back
+    Ramp cutoffTransform, scaledResonance;
+    float* drive = nullptr;
+    float* gain = nullptr;
+    float* drive2 = nullptr;
+    float* gain2 = nullptr;
+    FeedbackState feedback;
+
+    // Cutoff (in Hz), resonance and drive as set, plus a flag that any of them has changed..
+    PendingValues pendingCutoff, pendingResonance, pendingDrive;
+    std::atomic<bool> parametersPending { false };
+
+    // Per-chunk scratch, interleaved so that each row holds one sample of every filter..
+    float* inputBuffer = nullptr;                   // historyRows rows of history, then the chunk
+    float* drivenBuffer = nullptr;
+    float* outputBuffer = nullptr;
+    double* argumentBuffer = nullptr;
+    double* antiderivativeBuffer = nullptr;
+    double* differenceBuffer = nullptr;
+    const float** inputPointers = nullptr;          // channel pointers for the block version of process()
+    float** outputPointers = nullptr;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticLadderBank)
+};
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    AtticOversampler.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticOversampler.h"
+
+//==============================================================================
+namespace
+{
+    // Keeps each channel's region a whole number of cache lines long..
+    int roundToCacheLines (int numFloats) noexcept
+    {
+        constexpr int floatsPerLine = (int) (AtticArena::alignment / sizeof (float));
+        return (numFloats + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+    }
+
+    // The stage's delay at its higher rate is padded to a multiple of the rate ratio,
+    // so that it comes out as a whole number of host-rate samples..
+    int getPaddingDelay (int delay, int ratio) noexcept
+    {
+        return (ratio - delay % ratio) % ratio;
+    }
+}
+
+//==============================================================================
+void AtticOversampler::prepare (int newNumChannels, int order, int maximumBlockSize)
+{
+    jassert (order >= 1 && order <= AtticSharedTables::maximumOversamplingStages);
+    jassert (newNumChannels > 0 && maximumBlockSize > 0);
+
+    numStages = order;
+    numChannels = newNumChannels;
+    maxBlockSize = maximumBlockSize;
+    latency = 0;
+
+    arena.clear();
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[(size_t) s];
+        stage.up = &tables->upKernels[(size_t) s];
+        stage.down = &tables->downKernels[(size_t) s];
+
+        const auto ratio = 1 << (s + 1);
+        const auto delay = stage.up->centre + stage.down->centre;
+        stage.paddingDelay = getPaddingDelay (delay, ratio);
+        latency += (delay + stage.paddingDelay) / ratio;
+
+        const auto lastUpTap = (int) stage.up->denseTaps.size() - 1;
+        const auto lastDownTap = stage.down->firstDenseIndex + 2 * ((int) stage.down->denseTaps.size() - 1);
+        stage.upHistory = juce::jmax (lastUpTap, stage.up->centre / 2);
+        stage.downHistory = juce::jmax (lastDownTap, stage.down->centre) + stage.paddingDelay;
+
+        const auto lowBlockSize = maxBlockSize << s;
+        stage.upStride = roundToCacheLines (stage.upHistory + lowBlockSize);
+        stage.outputStride = roundToCacheLines (lowBlockSize * 2);
+        stage.downStride = roundToCacheLines (stage.downHistory + lowBlockSize * 2);
+
+        stage.upOffset = arena.add<float> ((size_t) (numChannels * stage.upStride));
+        stage.outputOffset = arena.add<float> ((size_t) (numChannels * stage.outputStride));
+        stage.downOffset = arena.add<float> ((size_t) (numChannels * stage.downStride));
+    }
+
+    const auto outputChannelsOffset = arena.add<float*> ((size_t) numChannels);
+    arena.allocate();
+
+    const auto& lastStage = stages[(size_t) numStages - 1];
+    outputChannels = arena.get<float*> (outputChannelsOffset);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        outputChannels[channel] = getChannel (lastStage.outputOffset, lastStage.outputStride, channel);
+}
+
+int AtticOversampler::getLatencyInSamples (int order)
+{
+    jassert (order >= 0 && order <= AtticSharedTables::maximumOversamplingStages);
+
+    juce::SharedResourcePointer<AtticSharedTables> sharedTables;
+    int total = 0;
+
+    for (int s = 0; s < order; ++s)
+    {
+        const auto ratio = 1 << (s + 1);
+        const auto delay = sharedTables->upKernels[(size_t) s].centre + sharedTables->downKernels[(size_t) s].centre;
+        total += (delay + getPaddingDelay (delay, ratio)) / ratio;
+    }
+
+    return total;
+}
+
+void AtticOversampler::reset() noexcept
+{
+    for (int s = 0; s < numStages; ++s)
+    {
+        const auto& stage = stages[(size_t) s];
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            juce::FloatVectorOperations::clear (getChannel (stage.upOffset, stage.upStride, channel), stage.upHistory);
+            juce::FloatVectorOperations::clear (getChannel (stage.downOffset, stage.downStride, channel), stage.downHistory);
+        }
+    }
+}
+
+//==============================================================================
+juce::dsp::AudioBlock<float> AtticOversampler::processSamplesUp (const juce::dsp::AudioBlock<const float>& inputBlock) noexcept
+{
+    const auto numSamples = (int) inputBlock.getNumSamples();
+
+    jassert ((int) inputBlock.getNumChannels() == numChannels);
+    jassert (numSamples <= maxBlockSize);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* input = inputBlock.getChannelPointer ((size_t) channel);
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            auto& stage = stages[(size_t) s];
+            auto* output = getChannel (stage.outputOffset, stage.outputStride, channel);
+
+            upsampleStage (stage, input, output, getChannel (stage.upOffset, stage.upStride, channel), numSamples << s);
+            input = output;
+        }
+    }
+
+    return { outputChannels, (size_t) numChannels, (size_t) (numSamples << numStages) };
+}
+
+void AtticOversampler::processSamplesDown (juce::dsp::AudioBlock<float>& outputBlock) noexcept
+{
+    const auto numSamples = (int) outputBlock.getNumSamples();
+
+    jassert ((int) outputBlock.getNumChannels() == numChannels);
+    jassert (numSamples <= maxBlockSize);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int s = numStages; --s >= 0;)
+        {
+            auto& stage = stages[(size_t) s];
+            const auto* input = getChannel (stage.outputOffset, stage.outputStride, channel);
+
+            // Each stage decimates into the buffer the stage below it upsampled into..
+            auto* output = s > 0 ? getChannel (stages[(size_t) s - 1].outputOffset, stages[(size_t) s - 1].outputStride, channel)
+                                 : outputBlock.getChannelPointer ((size_t) channel);
+
+            downsampleStage (stage, input, output, getChannel (stage.downOffset, stage.downStride, channel), numSamples << s);
+        }
+    }
+}
+
+//==============================================================================
+void AtticOversampler::upsampleStage (Stage& stage, const float* input, float* output, float* history, int numSamples) noexcept
+{
+    const auto& kernel = *stage.up;
+    const auto* taps = kernel.denseTaps.data();
+    const auto numTaps = (int) kernel.denseTaps.size();
+    const auto densePhase = kernel.firstDenseIndex;
+    const auto centrePhase = 1 - densePhase;
+    const auto centreLag = kernel.centre / 2;
+
+    auto* x = history + stage.upHistory;
+    std::copy (input, input + numSamples, x);
+
+    // One output phase is the dense half of the kernel, the other only sees its centre tap
+    // and is just the input, delayed. The factor of 2 makes up for the zero-stuffing..
+    for (int m = 0; m < numSamples; ++m)
+    {
+        auto sum = 0.0f;
+
+        for (int j = 0; j < numTaps; ++j)
+            sum += taps[j] * x[m - j];
+
+        output[2 * m + densePhase] = 2.0f * sum;
+        output[2 * m + centrePhase] = x[m - centreLag];
+    }
+
+    std::memmove (history, history + numSamples, (size_t) stage.upHistory * sizeof (float));
+}
+
+void AtticOversampler::downsampleStage (Stage& stage, const float* input, float* output, float* history, int numSamples) noexcept
+{
+    const auto& kernel = *stage.down;
+    const auto* taps = kernel.denseTaps.data();
+    const auto numTaps = (int) kernel.denseTaps.size();
+    const auto numInputSamples = numSamples * 2;
+
+    // Only every second output of the filter is needed, so that's all that gets computed..
+    auto* v = history + stage.downHistory - stage.paddingDelay;
+    std::copy (input, input + numInputSamples, history + stage.downHistory);
+
+    for (int m = 0; m < numSamples; ++m)
+    {
+        const auto* centre = v + 2 * m - kernel.firstDenseIndex;
+        auto sum = 0.5f * v[2 * m - kernel.centre];
+
+        for (int j = 0; j < numTaps; ++j)
+            sum += taps[j] * centre[-2 * j];
+
+        output[m] = sum;
+    }
+
+    std::memmove (history, history + numInputSamples, (size_t) stage.downHistory * sizeof (float));
+}
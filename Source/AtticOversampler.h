@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    AtticOversampler.h
+
+    A cascade of polyphase half-band FIR stages, used in place of
+    juce::dsp::Oversampling so that the kernels can be shared: they live in
+    AtticSharedTables and each instance only owns its filter histories. Each
+    stage pads its own delay so that the total latency is a whole number of
+    host-rate samples..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AtticSharedTables.h"
+#include "AtticArena.h"
+
+//==============================================================================
+/**
+*/
+class AtticOversampler
+{
+public:
+    //==============================================================================
+    AtticOversampler() = default;
+
+    // Oversamples by 2^order, with order from 1 to AtticSharedTables::maximumOversamplingStages..
+    void prepare (int numChannels, int order, int maximumBlockSize);
+    void reset() noexcept;
+
+    int getLatencyInSamples() const noexcept     { return latency; }
+    size_t getMemoryFootprint() const noexcept   { return sizeof (*this) + arena.getSize(); }
+
+    // The latency prepare() would give the order, without preparing anything. Order 0 has none..
+    static int getLatencyInSamples (int order);
+
+    // Same contract as juce::dsp::Oversampling: the block returned by processSamplesUp belongs to
+    // the oversampler and is what processSamplesDown reads back..
+    juce::dsp::AudioBlock<float> processSamplesUp (const juce::dsp::AudioBlock<const float>& inputBlock) noexcept;
+    void processSamplesDown (juce::dsp::AudioBlock<float>& outputBlock) noexcept;
+
+private:
+    //==============================================================================
+    struct Stage
+    {
+        const AtticSharedTables::HalfBandKernel* up = nullptr;
+        const AtticSharedTables::HalfBandKernel* down = nullptr;
+
+        int upHistory = 0, downHistory = 0;     // Samples kept between blocks, at the stage's lower and higher rate..
+        int paddingDelay = 0;                   // Extra delay at the higher rate to round the latency..
+        int upStride = 0, outputStride = 0, downStride = 0;
+        size_t upOffset = 0, outputOffset = 0, downOffset = 0;
+    };
+
+    void upsampleStage (Stage& stage, const float* input, float* output, float* history, int numSamples) noexcept;
+    void downsampleStage (Stage& stage, const float* input, float* output, float* history, int numSamples) noexcept;
+
+    float* getChannel (size_t offset, int stride, int channel) const noexcept
+    {
+        return arena.get<float> (offset) + (size_t) (channel * stride);
+    }
+
+    juce::SharedResourcePointer<AtticSharedTables> tables;
+    std::array<Stage, AtticSharedTables::maximumOversamplingStages> stages;
+    AtticArena arena;
+    float** outputChannels = nullptr;
+    int numStages = 0, numChannels = 0, maxBlockSize = 0, latency = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticOversampler)
+};
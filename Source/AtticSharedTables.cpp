@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    AtticSharedTables.cpp
+
+  ==============================================================================
+*/
+
+#include "AtticSharedTables.h"
+
+//==============================================================================
+namespace
+{
+    AtticSharedTables::HalfBandKernel designHalfBandKernel (float normalisedTransitionWidth, float stopbandAmplitudedB)
+    {
+        auto coefficients = juce::dsp::FilterDesign<float>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidth, stopbandAmplitudedB);
+        const auto* taps = coefficients->getRawCoefficients();
+
+        AtticSharedTables::HalfBandKernel kernel;
+        kernel.length = (int) coefficients->getFilterOrder() + 1;
+        kernel.centre = (kernel.length - 1) / 2;
+        kernel.firstDenseIndex = (kernel.centre + 1) % 2;
+
+        jassert (kernel.length % 2 == 1);
+        jassert (std::abs (taps[kernel.centre] - 0.5f) < 1.0e-4f);
+
+        for (int i = kernel.firstDenseIndex; i < kernel.length; i += 2)
+            kernel.denseTaps.push_back (taps[i]);
+
+        return kernel;
+    }
+}
+
+//==============================================================================
+AtticSharedTables::AtticSharedTables()
+{
+    // Follows juce::dsp::Oversampling's max quality FIR stages: the first stage needs the
+    // steepest filters, later ones have more room below their Nyquist and can relax..
+    for (int stage = 0; stage < maximumOversamplingStages; ++stage)
+    {
+        const auto widthScale = stage == 0 ? 0.5f : 1.0f;
+
+        upKernels[(size_t) stage] = designHalfBandKernel (0.10f * widthScale, -90.0f + 10.0f * (float) stage);
+        downKernels[(size_t) stage] = designHalfBandKernel (0.12f * widthScale, -75.0f + 10.0f * (float) stage);
+    }
+}
+
+size_t AtticSharedTables::getMemoryFootprint() const noexcept
+{
+    auto bytes = sizeof (*this);
+
+    for (auto* kernels : { &upKernels, &downKernels })
+        for (auto& kernel : *kernels)
+            bytes += kernel.denseTaps.capacity() * sizeof (float);
+
+    return bytes;
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    AtticSharedTables.h
+
+    Read-only DSP data that every Attic instance in the process can use:
+    the tanh lookup table and the half-band kernels of each oversampling
+    stage. Hold it through a juce::SharedResourcePointer<AtticSharedTables>;
+    it's built when the first instance asks for it and freed with the last..
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+*/
+class AtticSharedTables
+{
+public:
+    //==============================================================================
+    static constexpr int maximumOversamplingStages = 3;
+
+    // A half-band lowpass, split so that the filters can skip its zero taps. Offsets of the
+    // taps from the centre are either 0 or odd; the odd ones are kept in denseTaps..
+    struct HalfBandKernel
+    {
+        int length = 0;             // Number of taps of the full kernel..
+        int centre = 0;             // Index of its 0.5 centre tap, which is also its delay..
+        int firstDenseIndex = 0;    // Index in the full kernel of denseTaps[0], every second one follows..
+        std::vector<float> denseTaps;
+    };
+
+    AtticSharedTables();
+
+    // The lookup used by the ladder's saturation stages..
+    const juce::dsp::LookupTableTransform<float> tanhTable { [] (float x) { return std::tanh (x); }, -5.0f, 5.0f, 128 };
+
+    // Kernels of each 2x stage of the oversampler, from the host rate upwards..
+    std::array<HalfBandKernel, maximumOversamplingStages> upKernels, downKernels;
+
+    size_t getMemoryFootprint() const noexcept;
+
+private:
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticSharedTables)
+};
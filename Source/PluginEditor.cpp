@@ -14,7 +14,7 @@ AtticAudioProcessorEditor::AtticAudioProcessorEditor (AtticAudioProcessor& p, ju
     : AudioProcessorEditor (&p), audioProcessor (p), treeState(vts)
 {
     // Make sure that before the constructor has finished, you've set the editor's size to whatever you need it to be..
-    setSize (340, 280);
+    setSize (340, 390);
 
     // Cut-off Frequency
     cutoffValue = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>
@@ -50,10 +50,56 @@ AtticAudioProcessorEditor::AtticAudioProcessorEditor (AtticAudioProcessor& p, ju
     modeChoice = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
         (treeState, "mode", modeSel);
     addAndMakeVisible(&modeSel);
+
+    // Anti-aliasing
+    antialiasSel.addItem("Off", 1);
+    antialiasSel.addItem("ADAA1", 2);
+    antialiasSel.addItem("ADAA2", 3);
+    antialiasChoice = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+        (treeState, "antialias", antialiasSel);
+    addAndMakeVisible(&antialiasSel);
+
+    // Oversampling (realtime tier)
+    oversamplingSel.addItem("1x", 1);
+    oversamplingSel.addItem("2x", 2);
+    oversamplingSel.addItem("4x", 3);
+    oversamplingChoice = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+        (treeState, "oversampling", oversamplingSel);
+    addAndMakeVisible(&oversamplingSel);
+
+    // Render Quality (offline tier)
+    renderSel.addItem("Realtime", 1);
+    renderSel.addItem("High", 2);
+    renderSel.addItem("Maximum", 3);
+    renderChoice = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>
+        (treeState, "render", renderSel);
+    addAndMakeVisible(&renderSel);
+
+    // Adaptive Quality and CPU Budget
+    governorValue = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>
+        (treeState, "governor", governorButton);
+    addAndMakeVisible(&governorButton);
+
+    budgetValue = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>
+        (treeState, "budget", budgetSlider);
+    budgetSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    budgetSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::TextBoxRight, false, 50, 20);
+    budgetSlider.setTextValueSuffix("%");
+    budgetSlider.setNumDecimalPlacesToDisplay(0);
+    addAndMakeVisible(&budgetSlider);
+
+    // Quality status
+    statusLabel.setJustificationType(juce::Justification::centred);
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::whitesmoke);
+    addAndMakeVisible(&statusLabel);
+
+    timerCallback();
+    startTimerHz(4);
 }
 
 AtticAudioProcessorEditor::~AtticAudioProcessorEditor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -80,5 +126,29 @@ void AtticAudioProcessorEditor::resized()
     cutoffDial.setBounds(10, 100, 100, 100);
     resonanceDial.setBounds(120, 100, 100, 100);
     driveDial.setBounds(230, 100, 100, 100);
-    modeSel.setBounds(130, 230, 75, 25);
+    modeSel.setBounds(85, 230, 75, 25);
+    antialiasSel.setBounds(180, 230, 75, 25);
+    oversamplingSel.setBounds(85, 270, 75, 25);
+    renderSel.setBounds(180, 270, 75, 25);
+    governorButton.setBounds(20, 310, 90, 25);
+    budgetSlider.setBounds(110, 310, 210, 25);
+    statusLabel.setBounds(10, 350, 320, 25);
+}
+
+void AtticAudioProcessorEditor::timerCallback()
+{
+    const auto status = audioProcessor.getQualityStatus();
+    const juce::StringArray saturationNames = { "Lookup", "ADAA1", "ADAA2", "Exact" };
+
+    auto text = "Load " + juce::String(juce::roundToInt(status.load * 100.0f)) + "% | "
+              + juce::String(1 << status.tier.oversamplingOrder) + "x "
+              + saturationNames[(int) status.tier.saturation];
+
+    if (status.tier.controlInterval > 1)
+        text << " | control /" << status.tier.controlInterval;
+
+    if (status.reduced)
+        text << " (reduced)";
+
+    statusLabel.setText(text, juce::dontSendNotification);
 }
\ No newline at end of file
@@ -14,7 +14,8 @@
 //==============================================================================
 /**
 */
-class AtticAudioProcessorEditor  : public juce::AudioProcessorEditor
+class AtticAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                   private juce::Timer
 {
 public:
     AtticAudioProcessorEditor (AtticAudioProcessor&, juce::AudioProcessorValueTreeState&);
@@ -25,6 +26,8 @@ public:
     void resized() override;
 
 private:
+    void timerCallback() override; // Refreshes the quality status reported by the processor..
+
     // This reference is provided as a quick way for your editor to access processor object that created it..
     AtticAudioProcessor& audioProcessor;
     juce::AudioProcessorValueTreeState& treeState;
@@ -34,11 +37,22 @@ private:
     juce::Slider resonanceDial;
     juce::Slider driveDial;
     juce::ComboBox modeSel;
+    juce::ComboBox antialiasSel;
+    juce::ComboBox oversamplingSel;
+    juce::ComboBox renderSel;
+    juce::ToggleButton governorButton { "Adaptive" };
+    juce::Slider budgetSlider;
+    juce::Label statusLabel;
 
     std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> cutoffValue;
     std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> resonanceValue;
     std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> driveValue;
     std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeChoice;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> antialiasChoice;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingChoice;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> renderChoice;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::ButtonAttachment> governorValue;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> budgetValue;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticAudioProcessorEditor)
 };
\ No newline at end of file
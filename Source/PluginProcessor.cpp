@@ -25,11 +25,19 @@ AtticAudioProcessor::AtticAudioProcessor()
                            std::make_unique<juce::AudioParameterFloat>("resonance", "Resonance", 0.0f, 1.0f, 0.1f),
                            std::make_unique<juce::AudioParameterFloat>("drive", "Drive", 1.0f, 25.0f, 1.0f),
                            std::make_unique<juce::AudioParameterChoice>("mode", "Filter Type",
-                           juce::StringArray("LPF12", "LPF24", "HPF12", "HPF24", "BPF12", "BPF24"), 0) })
+                           juce::StringArray("LPF12", "LPF24", "HPF12", "HPF24", "BPF12", "BPF24"), 0),
+                           std::make_unique<juce::AudioParameterChoice>("antialias", "Anti-aliasing",
+                           juce::StringArray("Off", "ADAA1", "ADAA2"), 0),
+                           std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling",
+                           juce::StringArray("1x", "2x", "4x"), 0),
+                           std::make_unique<juce::AudioParameterChoice>("render", "Render Quality",
+                           juce::StringArray("Realtime", "High", "Maximum"), 1),
+                           std::make_unique<juce::AudioParameterBool>("governor", "Adaptive Quality", true),
+                           std::make_unique<juce::AudioParameterFloat>("budget", "CPU Budget", 1.0f, 100.0f, 10.0f) })
 #endif
 {
-    const juce::StringArray params = { "cutoff", "resonance", "drive", "mode" }; // Adds each parameter into a string array called 'params'..
-    for (int i = 0; i <= 3; ++i)
+    const juce::StringArray params = { "cutoff", "resonance", "drive", "mode", "antialias", "governor", "budget" }; // Adds each parameter into a string array called 'params'..
+    for (int i = 0; i < params.size(); ++i)
     {
         // Adds a listener to each parameter in the array..
         treeState.addParameterListener(params[i], this);
@@ -106,15 +114,79 @@ void AtticAudioProcessor::changeProgramName (int index, const juce::String& newN
 void AtticAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     // Use this method as the place to do any pre-playback initialisation that you need..
-    juce::dsp::ProcessSpec spec;
+    // Offline renders get their own, heavier quality tier..
+    preparedOffline = isNonRealtime();
+    activeTier = preparedOffline ? getOfflineTier() : getRealtimeTier();
+    realtimeSaturation = (int) treeState.getRawParameterValue("antialias")->load();
 
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
+    const auto numChannels = getTotalNumOutputChannels();
 
-    ladderFilter.reset();
-    ladderFilter.prepare(spec);
-    ladderFilter.setEnabled(true);
+    // In realtime the governor may fall back to any factor below the tier's, so those are prepared too..
+    const auto lowestOrder = preparedOffline ? activeTier.oversamplingOrder : 0;
+
+    for (int order = 0; order <= maximumOversamplingOrder; ++order)
+    {
+        auto& path = paths[(size_t) order];
+        path.release();
+
+        if (order < lowestOrder || order > activeTier.oversamplingOrder)
+            continue;
+
+        path.prepared = true;
+
+        if (order > 0)
+        {
+            // Linear-phase half-band filters with an integer latency, so that every path only
+            // differs from the others by a delay that can be compensated exactly..
+            path.oversampling = std::make_unique<AtticOversampler>();
+            path.oversampling->prepare(numChannels, order, samplesPerBlock);
+        }
+
+        juce::dsp::ProcessSpec spec;
+
+        spec.sampleRate = sampleRate * (1 << order);
+        spec.maximumBlockSize = (juce::uint32) (samplesPerBlock * (1 << order));
+        spec.numChannels = (juce::uint32) numChannels;
+
+        path.ladder.prepare(spec);
+    }
+
+    // The host is told one latency whichever tier is running, the largest of the tiers the settings
+    // can select, so switching between realtime and offline doesn't move the audio. The paths of
+    // the tiers below it are padded up to it..
+    const auto highestOrder = juce::jmax(getRealtimeTier().oversamplingOrder, getOfflineTier().oversamplingOrder);
+    const auto latency = AtticOversampler::getLatencyInSamples(highestOrder);
+    const juce::dsp::ProcessSpec hostSpec { sampleRate, (juce::uint32) samplesPerBlock, (juce::uint32) numChannels };
+
+    for (int order = lowestOrder; order <= activeTier.oversamplingOrder; ++order)
+    {
+        auto& path = paths[(size_t) order];
+
+        path.compensationSamples = latency - AtticOversampler::getLatencyInSamples(order);
+        jassert (order == 0 || path.oversampling->getLatencyInSamples() == AtticOversampler::getLatencyInSamples(order));
+        path.latencyCompensation.prepare(hostSpec);
+        path.latencyCompensation.setMaximumDelayInSamples(juce::jmax(1, path.compensationSamples));
+        path.latencyCompensation.setDelay((float) path.compensationSamples);
+        path.latencyCompensation.reset();
+    }
+
+    setLatencySamples(latency);
+    crossfadeBuffer.setSize(numChannels, samplesPerBlock);
+    crossfadeSamples = juce::jmax(1, juce::roundToInt(sampleRate * pathCrossfadeTimeSec));
+    outgoingPath = -1;
+
+    // Pushes the current parameter values into the filters, so they don't start from their own defaults
+    // and don't glide from them when the tier changes..
+    for (auto* id : { "cutoff", "resonance", "drive", "mode", "governor", "budget" })
+        parameterChanged(id, treeState.getRawParameterValue(id)->load());
+
+    buildQualitySteps();
+    governor.prepare(sampleRate, numQualitySteps - 1);
+    applyQualityStep(0);
+
+    for (auto& path : paths)
+        if (path.prepared)
+            path.ladder.reset();
 }
 
 void AtticAudioProcessor::releaseResources()
@@ -151,6 +223,7 @@ bool AtticAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 void AtticAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -158,13 +231,120 @@ void AtticAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
         buffer.clear (i, 0, buffer.getNumSamples());
 
     juce::dsp::AudioBlock<float> block(buffer);
-    auto processingContext = juce::dsp::ProcessContextReplacing<float>(block);
-    ladderFilter.process(processingContext);
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // A live change of "antialias" re-derives the steps the governor can take..
+    if (! preparedOffline && (int) activeTier.saturation != realtimeSaturation.load())
     {
-        auto* channelData = buffer.getWritePointer (channel);
+        activeTier.saturation = (AtticLadder::Saturation) realtimeSaturation.load();
+        buildQualitySteps();
+        appliedStep = -1;
     }
+
+    const auto step = juce::jmin(governor.getLevel(), numQualitySteps - 1);
+
+    // A new step waits for the previous change of path to finish..
+    if (step != appliedStep && outgoingPath < 0)
+    {
+        const auto previousPath = activePath;
+        applyQualityStep(step);
+
+        if (activePath != previousPath)
+            beginPathChange(previousPath);
+    }
+
+    const auto numSamples = buffer.getNumSamples();
+
+    // A block longer than the one prepared for can't be run through both paths, so the change is cut short..
+    if (outgoingPath >= 0 && numSamples > crossfadeBuffer.getNumSamples())
+        outgoingPath = -1;
+
+    if (outgoingPath >= 0)
+        processPathChange(buffer);
+    else
+        processPath(paths[(size_t) activePath], block);
+
+    if (! preparedOffline)
+        governor.update(startTicks, numSamples);
+}
+
+void AtticAudioProcessor::beginPathChange(int previousPath)
+{
+    // The incoming path has been idle, so it starts again from a clean state..
+    auto& incoming = paths[(size_t) activePath];
+    incoming.ladder.reset();
+    incoming.latencyCompensation.reset();
+
+    if (incoming.oversampling != nullptr)
+        incoming.oversampling->reset();
+
+    outgoingPath = previousPath;
+    pathChangePosition = 0;
+}
+
+void AtticAudioProcessor::processPathChange(juce::AudioBuffer<float>& buffer)
+{
+    const auto numChannels = getTotalNumOutputChannels();
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        crossfadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+    juce::dsp::AudioBlock<float> incomingBlock(buffer);
+    juce::dsp::AudioBlock<float> outgoingBlock(crossfadeBuffer.getArrayOfWritePointers(), (size_t) numChannels, (size_t) numSamples);
+    processPath(paths[(size_t) outgoingPath], outgoingBlock);
+    processPath(paths[(size_t) activePath], incomingBlock);
+
+    // Every path is delayed to the same total latency, so that's how long the incoming one
+    // gives out nothing but the silence it was reset to..
+    const auto fadeStart = getLatencySamples();
+    const auto fadeEnd = fadeStart + crossfadeSamples;
+
+    auto getIncomingGain = [this, fadeStart](int position)
+    {
+        return juce::jlimit(0.0f, 1.0f, (float) (position - fadeStart) / (float) crossfadeSamples);
+    };
+
+    // This block's share of the change: the outgoing path alone up to holdEnd, the crossfade up
+    // to fadeEndInBlock, and the incoming path alone after that..
+    const auto holdEnd = juce::jlimit(0, numSamples, fadeStart - pathChangePosition);
+    const auto fadeEndInBlock = juce::jlimit(0, numSamples, fadeEnd - pathChangePosition);
+    const auto startGain = getIncomingGain(pathChangePosition + holdEnd);
+    const auto endGain = getIncomingGain(pathChangePosition + fadeEndInBlock);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (holdEnd > 0)
+            buffer.copyFrom(channel, 0, crossfadeBuffer, channel, 0, holdEnd);
+
+        if (fadeEndInBlock > holdEnd)
+        {
+            buffer.applyGainRamp(channel, holdEnd, fadeEndInBlock - holdEnd, startGain, endGain);
+            buffer.addFromWithRamp(channel, holdEnd, crossfadeBuffer.getReadPointer(channel, holdEnd),
+                                   fadeEndInBlock - holdEnd, 1.0f - startGain, 1.0f - endGain);
+        }
+    }
+
+    pathChangePosition += numSamples;
+
+    if (pathChangePosition >= fadeEnd)
+        outgoingPath = -1;
+}
+
+void AtticAudioProcessor::processPath(ProcessingPath& path, juce::dsp::AudioBlock<float>& block)
+{
+    if (path.oversampling != nullptr)
+    {
+        auto oversampledBlock = path.oversampling->processSamplesUp(block);
+        path.ladder.process(juce::dsp::ProcessContextReplacing<float>(oversampledBlock));
+        path.oversampling->processSamplesDown(block);
+    }
+    else
+    {
+        path.ladder.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+
+    if (path.compensationSamples > 0)
+        path.latencyCompensation.process(juce::dsp::ProcessContextReplacing<float>(block));
 }
 
 //==============================================================================
@@ -195,6 +375,166 @@ void AtticAudioProcessor::setStateInformation (const void* data, int sizeInBytes
             treeState.replaceState(juce::ValueTree::fromXml(*xmlState));
 }
 
+//==============================================================================
+// The realtime tier follows the user's settings and stays lightweight..
+AtticAudioProcessor::QualityTier AtticAudioProcessor::getRealtimeTier() const
+{
+    QualityTier tier;
+    tier.oversamplingOrder = (int) treeState.getRawParameterValue("oversampling")->load();
+    tier.saturation = (AtticLadder::Saturation) (int) treeState.getRawParameterValue("antialias")->load();
+    return tier;
+}
+
+// The offline tier is picked by the "render" parameter. There's no CPU budget to meet, so
+// anything above "Realtime" trades speed for quality..
+AtticAudioProcessor::QualityTier AtticAudioProcessor::getOfflineTier() const
+{
+    switch ((int) treeState.getRawParameterValue("render")->load())
+    {
+        case 1: return { 2, AtticLadder::Saturation::Exact };  // High: 4x oversampling, exact tanh
+        case 2: return { 3, AtticLadder::Saturation::ADAA2 };  // Maximum: 8x oversampling on top of ADAA2
+        default: break;
+    }
+
+    return getRealtimeTier();
+}
+
+// Each step down gives up oversampling first, then saturator precision, then control rate..
+void AtticAudioProcessor::buildQualitySteps()
+{
+    auto tier = activeTier;
+
+    numQualitySteps = 0;
+    qualitySteps[(size_t) numQualitySteps++] = tier;
+
+    // There is no deadline when rendering offline, so the tier is never stepped down there..
+    if (! preparedOffline)
+    {
+        while (tier.oversamplingOrder > 0)
+        {
+            --tier.oversamplingOrder;
+            qualitySteps[(size_t) numQualitySteps++] = tier;
+        }
+
+        if (tier.saturation == AtticLadder::Saturation::ADAA2)
+        {
+            tier.saturation = AtticLadder::Saturation::ADAA1;
+            qualitySteps[(size_t) numQualitySteps++] = tier;
+        }
+
+        if (tier.saturation != AtticLadder::Saturation::Lookup)
+        {
+            tier.saturation = AtticLadder::Saturation::Lookup;
+            qualitySteps[(size_t) numQualitySteps++] = tier;
+        }
+
+        for (auto interval : { 4, 16 })
+        {
+            tier.controlInterval = interval;
+            qualitySteps[(size_t) numQualitySteps++] = tier;
+        }
+    }
+
+    jassert (numQualitySteps <= maximumQualitySteps);
+    governor.setMaximumLevel(numQualitySteps - 1);
+}
+
+void AtticAudioProcessor::applyQualityStep(int step)
+{
+    const auto& tier = qualitySteps[(size_t) step];
+    auto& path = paths[(size_t) tier.oversamplingOrder];
+
+    // Every step's path was prepared along with the tier, so this only guards against a step
+    // built for other settings..
+    if (! path.prepared)
+    {
+        jassertfalse;
+        return;
+    }
+
+    path.ladder.setSaturation(tier.saturation);
+    path.ladder.setControlInterval(tier.controlInterval);
+
+    activePath = tier.oversamplingOrder;
+    appliedStep = step;
+
+    reportedOversamplingOrder = tier.oversamplingOrder;
+    reportedSaturation = (int) tier.saturation;
+    reportedControlInterval = tier.controlInterval;
+    reportedReduced = step > 0;
+}
+
+AtticAudioProcessor::QualityStatus AtticAudioProcessor::getQualityStatus() const
+{
+    QualityStatus status;
+    status.tier.oversamplingOrder = reportedOversamplingOrder.load();
+    status.tier.saturation = (AtticLadder::Saturation) reportedSaturation.load();
+    status.tier.controlInterval = reportedControlInterval.load();
+    status.load = governor.getLoad();
+    status.reduced = reportedReduced.load();
+    return status;
+}
+
+size_t AtticAudioProcessor::getMemoryFootprint() const
+{
+    auto bytes = sizeof (*this) + crossfadeBuffer.getNumChannels() * crossfadeBuffer.getNumSamples() * sizeof (float);
+
+    // Every path is counted: the ones the tier doesn't use have been released, so theirs is just what's left..
+    for (auto& path : paths)
+    {
+        bytes += path.ladder.getMemoryFootprint() - sizeof (path.ladder);
+
+        if (path.oversampling != nullptr)
+            bytes += path.oversampling->getMemoryFootprint();
+
+        // The delay line keeps one more sample than its maximum delay, per channel. A released one keeps none..
+        if (path.prepared)
+            bytes += (size_t) (crossfadeBuffer.getNumChannels() * (juce::jmax(1, path.compensationSamples) + 1)) * sizeof (float);
+    }
+
+    return bytes + getParameterFootprint();
+}
+
+// The parameters are owned per instance as well. Their smoothing is done by the ladders' ramps,
+// which are counted with the ladders. This counts the parameter objects with their strings and
+// the properties each one keeps in the tree's state, leaving out the allocator's own overhead..
+size_t AtticAudioProcessor::getParameterFootprint() const
+{
+    auto getStringBytes = [](const juce::String& text)
+    {
+        return text.isEmpty() ? (size_t) 0 : text.getNumBytesAsUTF8() + 1;
+    };
+
+    size_t bytes = 0;
+
+    for (auto* parameter : getParameters())
+    {
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(parameter))
+        {
+            bytes += sizeof (*choice);
+
+            for (auto& name : choice->choices)
+                bytes += sizeof (name) + getStringBytes(name);
+        }
+        else if (dynamic_cast<juce::AudioParameterFloat*>(parameter) != nullptr)
+        {
+            bytes += sizeof (juce::AudioParameterFloat);
+        }
+        else if (dynamic_cast<juce::AudioParameterBool*>(parameter) != nullptr)
+        {
+            bytes += sizeof (juce::AudioParameterBool);
+        }
+
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            bytes += getStringBytes(withID->paramID) + getStringBytes(withID->name) + getStringBytes(withID->label);
+    }
+
+    for (const auto& child : treeState.state)
+        bytes += (size_t) child.getNumProperties() * sizeof (juce::NamedValueSet::NamedValue);
+
+    return bytes;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -206,30 +546,30 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 void AtticAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
 {
     if (parameterID == "cutoff")
-        ladderFilter.setCutoffFrequencyHz(newValue);
+        for (auto& path : paths)
+            path.ladder.setCutoffFrequencyHz(newValue);
 
     else if (parameterID == "resonance")
-        ladderFilter.setResonance(newValue);
+        for (auto& path : paths)
+            path.ladder.setResonance(newValue);
 
     else if (parameterID == "drive")
-        ladderFilter.setDrive(newValue);
+        for (auto& path : paths)
+            path.ladder.setDrive(newValue);
 
     else if (parameterID == "mode")
-    {
-        switch ((int)newValue)
-        {
-            case 0: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::LPF12);
-                break;
-            case 1: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::LPF24);
-                break;
-            case 2: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::HPF12);
-                break;
-            case 3: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::HPF24);
-                break;
-            case 4: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::BPF12);
-                break;
-            case 5: ladderFilter.setMode(juce::dsp::LadderFilter<float>::Mode::BPF24);
-                break;
-        }
-    }
+        for (auto& path : paths)
+            path.ladder.setMode((AtticLadder::Mode)(int)newValue); // The choice entries follow the order of AtticLadder::Mode..
+
+    // Only the realtime tier follows this live, it's picked up at the start of the next block..
+    else if (parameterID == "antialias")
+        realtimeSaturation = (int)newValue;
+
+    else if (parameterID == "governor")
+        governor.setEnabled(newValue >= 0.5f);
+
+    else if (parameterID == "budget")
+        governor.setBudget(newValue / 100.0f);
+
+    // "oversampling" and "render" change the latency, so they take effect in the next prepareToPlay..
 }
@@ -8,6 +8,9 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "AtticLadder.h"
+#include "AtticGovernor.h"
+#include "AtticOversampler.h"
 
 //==============================================================================
 /**
@@ -56,9 +59,86 @@ public:
 
     void parameterChanged(const juce::String& parameterID, float newValue) override; // Relates to function at end of processor.cpp file..
 
+    //==============================================================================
+    // Processing quality, chosen in prepareToPlay depending on whether the host is rendering offline..
+    struct QualityTier
+    {
+        int oversamplingOrder = 0; // Processes at 2^order times the host sample rate..
+        AtticLadder::Saturation saturation = AtticLadder::Saturation::Lookup;
+        int controlInterval = 1;   // Samples between updates of the smoothed cutoff and resonance..
+    };
+
+    // What the CPU governor is currently running, for the editor..
+    struct QualityStatus
+    {
+        QualityTier tier;
+        float load = 0.0f;         // Smoothed share of the block's deadline spent in processBlock..
+        bool reduced = false;      // True when the governor has stepped down from the chosen tier..
+    };
+
+    QualityStatus getQualityStatus() const;
+
+    // Bytes of DSP state and parameters this instance owns, leaving out the tables every instance shares..
+    size_t getMemoryFootprint() const;
+
 private:
+    static constexpr int maximumOversamplingOrder = 3;
+    static constexpr int maximumQualitySteps = 8;
+    static constexpr double pathCrossfadeTimeSec = 0.01;
+
+    // One oversampling factor with its own ladder, so the governor can move between factors mid-stream.
+    // Paths with less latency than the one reported to the host are delayed to match it..
+    struct ProcessingPath
+    {
+        std::unique_ptr<AtticOversampler> oversampling; // nullptr when running at the host rate..
+        AtticLadder ladder;
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> latencyCompensation;
+        int compensationSamples = 0;
+        bool prepared = false;
+
+        // Frees what a previous, higher tier allocated, for paths the current tier doesn't use..
+        void release()
+        {
+            oversampling.reset();
+            ladder.release();
+            latencyCompensation = {};
+            compensationSamples = 0;
+            prepared = false;
+        }
+    };
+
+    QualityTier getRealtimeTier() const;
+    QualityTier getOfflineTier() const;
+    void buildQualitySteps();
+    void applyQualityStep(int step);
+    void beginPathChange(int previousPath);
+    void processPathChange(juce::AudioBuffer<float>& buffer);
+    void processPath(ProcessingPath& path, juce::dsp::AudioBlock<float>& block);
+    size_t getParameterFootprint() const;
+
     juce::AudioProcessorValueTreeState treeState;
-    juce::dsp::LadderFilter<float> ladderFilter;
+    std::array<ProcessingPath, maximumOversamplingOrder + 1> paths;
+    juce::AudioBuffer<float> crossfadeBuffer;
+
+    // A change of path in progress, which can span several blocks. The incoming path starts from
+    // a reset, so only the outgoing one is heard until the incoming one has filled its latency,
+    // then the two are crossfaded over crossfadeSamples..
+    int outgoingPath = -1, pathChangePosition = 0, crossfadeSamples = 1;
+
+    // Whether prepareToPlay set things up for an offline render. Hosts may flip isNonRealtime()
+    // without preparing again, so processing goes by this instead..
+    bool preparedOffline = false;
+
+    // qualitySteps[0] is the active tier, each following entry a little cheaper than the last..
+    QualityTier activeTier;
+    std::array<QualityTier, maximumQualitySteps> qualitySteps;
+    int numQualitySteps = 1, appliedStep = 0, activePath = 0;
+    AtticGovernor governor;
+
+    std::atomic<int> realtimeSaturation { 0 };
+    std::atomic<int> reportedOversamplingOrder { 0 }, reportedSaturation { 0 }, reportedControlInterval { 1 };
+    std::atomic<bool> reportedReduced { false };
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AtticAudioProcessor)
 };